@@ -14,7 +14,7 @@ enum
     paramControlHeight = 40,
     paramLabelWidth    = 120,
     paramSliderWidth   = 300,
-    uiRows = 5 // for calculating label spacing of parameters + comment/copyright label
+    uiRows = 9 // for calculating label spacing of parameters + comment/copyright label
 };
 
 //==============================================================================
@@ -40,12 +40,51 @@ MdaAmbienceAudioProcessorEditor::MdaAmbienceAudioProcessorEditor (MdaAmbienceAud
     addAndMakeVisible(outputLabel);
     addAndMakeVisible(outputSlider);
     outputAttachment.reset(new juce::AudioProcessorValueTreeState::SliderAttachment (apvts, "output", outputSlider));
+
+    inputMeterLabel.setText("Input", juce::dontSendNotification);
+    addAndMakeVisible(inputMeterLabel);
+    addAndMakeVisible(inputMeterL);
+    addAndMakeVisible(inputMeterR);
+
+    outputMeterLabel.setText("Output", juce::dontSendNotification);
+    addAndMakeVisible(outputMeterLabel);
+    addAndMakeVisible(outputMeterL);
+    addAndMakeVisible(outputMeterR);
+
+    decayLabel.setText("Decay", juce::dontSendNotification);
+    addAndMakeVisible(decayLabel);
+    addAndMakeVisible(decayMeter);
+
+    tailLabel.setText("Tail", juce::dontSendNotification);
+    addAndMakeVisible(tailLabel);
+    addAndMakeVisible(tailMeter);
+
+    dspStateButton.setToggleState(audioProcessor.getSavesDspState(), juce::dontSendNotification);
+    dspStateButton.onClick = [this] { audioProcessor.setSavesDspState(dspStateButton.getToggleState()); };
+    addAndMakeVisible(dspStateButton);
+
+    audioProcessor.meters.addConsumer();
     
     setSize (paramSliderWidth + paramLabelWidth, juce::jmax (100, paramControlHeight * uiRows));
 }
 
 MdaAmbienceAudioProcessorEditor::~MdaAmbienceAudioProcessorEditor()
 {
+    audioProcessor.meters.removeConsumer();
+}
+
+// called on every display refresh, only repaints the meters that moved
+void MdaAmbienceAudioProcessorEditor::updateMeters()
+{
+    if (! audioProcessor.meters.pull(meterFrame))
+        return;
+
+    inputMeterL.setValue(meterFrame.inputPeak[0]);
+    inputMeterR.setValue(meterFrame.inputPeak[1]);
+    outputMeterL.setValue(meterFrame.outputPeak[0]);
+    outputMeterR.setValue(meterFrame.outputPeak[1]);
+    decayMeter.setValue(meterFrame.values[0]);
+    tailMeter.setValue(meterFrame.values[1]);
 }
 
 //==============================================================================
@@ -65,6 +104,9 @@ void MdaAmbienceAudioProcessorEditor::resized()
     auto r = getLocalBounds();
     auto sliderHeight = r.getHeight() / uiRows;
 
+    // shares the bottom row with the credits
+    dspStateButton.setBounds(r.removeFromBottom(sliderHeight).removeFromLeft(paramLabelWidth));
+
     auto labelRect = juce::Rectangle<int>(0, 0, paramLabelWidth, sliderHeight);
     auto sliderRect = juce::Rectangle<int>(paramLabelWidth, 0, paramSliderWidth, sliderHeight);
 
@@ -85,4 +127,31 @@ void MdaAmbienceAudioProcessorEditor::resized()
     sliderRect.translate(0, sliderHeight);
     outputLabel.setBounds(labelRect);
     outputSlider.setBounds(sliderRect);
+
+    // meter rows, stereo meters are split into two bars
+    auto meterRect = sliderRect.reduced(4, sliderHeight / 4);
+
+    labelRect.translate(0, sliderHeight);
+    meterRect.translate(0, sliderHeight);
+    inputMeterLabel.setBounds(labelRect);
+    auto stereoRect = meterRect;
+    inputMeterL.setBounds(stereoRect.removeFromTop(meterRect.getHeight() / 2 - 1));
+    inputMeterR.setBounds(stereoRect.removeFromBottom(meterRect.getHeight() / 2 - 1));
+
+    labelRect.translate(0, sliderHeight);
+    meterRect.translate(0, sliderHeight);
+    outputMeterLabel.setBounds(labelRect);
+    stereoRect = meterRect;
+    outputMeterL.setBounds(stereoRect.removeFromTop(meterRect.getHeight() / 2 - 1));
+    outputMeterR.setBounds(stereoRect.removeFromBottom(meterRect.getHeight() / 2 - 1));
+
+    labelRect.translate(0, sliderHeight);
+    meterRect.translate(0, sliderHeight);
+    decayLabel.setBounds(labelRect);
+    decayMeter.setBounds(meterRect);
+
+    labelRect.translate(0, sliderHeight);
+    meterRect.translate(0, sliderHeight);
+    tailLabel.setBounds(labelRect);
+    tailMeter.setBounds(meterRect);
 }
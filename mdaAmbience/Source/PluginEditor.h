@@ -48,5 +48,27 @@ private:
     juce::Label outputLabel;
     juce::Slider outputSlider;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> outputAttachment;
+
+    // live meters, fed from the processor's MeterSource on every display refresh
+    juce::Label inputMeterLabel;
+    mda::BarMeter inputMeterL { mda::BarMeter::Scale::decibels, -60.0f, 6.0f };
+    mda::BarMeter inputMeterR { mda::BarMeter::Scale::decibels, -60.0f, 6.0f };
+
+    juce::Label outputMeterLabel;
+    mda::BarMeter outputMeterL { mda::BarMeter::Scale::decibels, -60.0f, 6.0f };
+    mda::BarMeter outputMeterR { mda::BarMeter::Scale::decibels, -60.0f, 6.0f };
+
+    juce::Label decayLabel;
+    mda::BarMeter decayMeter { mda::BarMeter::Scale::linear, 0.0f, 1.0f };
+
+    juce::Label tailLabel;
+    mda::BarMeter tailMeter { mda::BarMeter::Scale::decibels, -60.0f, 6.0f };
+
+    // opt-in snapshot of the delay lines & filter states in the saved state
+    juce::ToggleButton dspStateButton { "Save DSP state" };
+
+    mda::MeterFrame meterFrame;
+    void updateMeters();
+    juce::VBlankAttachment vBlankAttachment { this, [this] { updateMeters(); } };
     
 };
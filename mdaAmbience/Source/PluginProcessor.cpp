@@ -9,359 +9,259 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
-namespace ParameterID
-{
-    #define PARAMETER_ID(str) const juce::ParameterID str(#str, 1);
-
-    PARAMETER_ID(size)
-    PARAMETER_ID(hf)
-    PARAMETER_ID(mix)
-    PARAMETER_ID(output)
-
-    #undef PARAMETER_ID
-}
-
-// Returns a typed pointer to a juce::AudioParameterXXX object from the APVTS.
-template<typename T>
-inline static void castParameter(juce::AudioProcessorValueTreeState& apvts, const juce::ParameterID& id, T& destination)
-{
-    destination = dynamic_cast<T>(apvts.getParameter(id.getParamID()));
-    jassert(destination);
-}
-
-#ifdef DEBUG
-inline void checkSample(float& x) {
-    if (std::isnan(x)) {
-        DBG("!!! WARNING: nan detected in audio buffer, silencing !!!");
-        x = 0.0f;
-    } else if (std::isinf(x)) {
-        DBG("!!! WARNING: inf detected in audio buffer, silencing !!!");
-        x = 0.0f;
-    } else if (x < -2.0f || x > 2.0f) {  // screaming feedback
-        DBG("!!! WARNING: sample out of range, silencing !!!");
-        x = 0.0f;
-    } else if (x < -1.0f) {
-        x = -1.0f;
-    } else if (x > 1.0f) {
-        x = 1.0f;
-    }
-}
-#endif
-
 //==============================================================================
 MdaAmbienceAudioProcessor::MdaAmbienceAudioProcessor()
-#ifndef JucePlugin_PreferredChannelConfigurations
-     : AudioProcessor (BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                       )
-#endif
 {
-    castParameter(apvts, ParameterID::size, sizeParam);
-    castParameter(apvts, ParameterID::hf, hfParam);
-    castParameter(apvts, ParameterID::mix, mixParam);
-    castParameter(apvts, ParameterID::output, outputParam);
-    apvts.state.addListener(this);
-        
-    buf1 = new float[1024];
-    buf2 = new float[1024];
-    buf3 = new float[1024];
-    buf4 = new float[1024];
-    
     reset();
 }
 
 MdaAmbienceAudioProcessor::~MdaAmbienceAudioProcessor()
 {
-    apvts.state.removeListener(this);
-
-    if(buf1) delete [] buf1;
-    if(buf2) delete [] buf2;
-    if(buf3) delete [] buf3;
-    if(buf4) delete [] buf4;
 }
 
 //==============================================================================
-const juce::String MdaAmbienceAudioProcessor::getName() const
+void MdaAmbienceAudioProcessor::prepareResources (double sampleRate, int)
 {
-    return JucePlugin_Name;
-}
+    // offline renders get the denser diffusion
+    auto numBuffers = highQuality ? 6 : 4;
+    allpassBuffers.allocate(numBuffers * kAllpassSize);
 
-bool MdaAmbienceAudioProcessor::acceptsMidi() const
-{
-   #if JucePlugin_WantsMidiInput
-    return true;
-   #else
-    return false;
-   #endif
+    float* bufs[6] {};
+    for (auto n = 0; n < numBuffers; ++n) {
+        bufs[n] = allpassBuffers.get() + n * kAllpassSize;
+    }
+    buf1 = bufs[0]; buf2 = bufs[1]; buf3 = bufs[2];
+    buf4 = bufs[3]; buf5 = bufs[4]; buf6 = bufs[5];
 }
 
-bool MdaAmbienceAudioProcessor::producesMidi() const
+void MdaAmbienceAudioProcessor::prepareSmoothing (double sampleRate)
 {
-   #if JucePlugin_ProducesMidiOutput
-    return true;
-   #else
-    return false;
-   #endif
+    for (auto* smoother : { &dampSmoother, &wetSmoother, &drySmoother }) {
+        smoother->reset(sampleRate, kSmoothingTime);
+    }
 }
 
-bool MdaAmbienceAudioProcessor::isMidiEffect() const
+void MdaAmbienceAudioProcessor::reset()
 {
-   #if JucePlugin_IsMidiEffect
-    return true;
-   #else
-    return false;
-   #endif
+    state = {};
+    allpassBuffers.clear();
+    rdy = 1;
 }
 
-double MdaAmbienceAudioProcessor::getTailLengthSeconds() const
+// the live state for the optional snapshot in the saved state, in a fixed order
+void MdaAmbienceAudioProcessor::saveDspState (mda::DspStateWriter& writer) const
 {
-    return 0.0;
+    writer.write(state.fil);
+    writer.write(state.pos);
+    writer.write(state.den);
+    writer.writeSamples(allpassBuffers.get(), allpassBuffers.getSize());
 }
 
-int MdaAmbienceAudioProcessor::getNumPrograms()
+bool MdaAmbienceAudioProcessor::loadDspState (mda::DspStateReader& reader)
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
-}
+    State st;
+    auto ok = reader.read(st.fil) && reader.read(st.pos) && reader.read(st.den)
+           && st.pos >= 0 && st.pos < (long)kAllpassSize
+           && reader.readSamples(allpassBuffers.get(), allpassBuffers.getSize());
 
-int MdaAmbienceAudioProcessor::getCurrentProgram()
-{
-    return 0;
-}
+    if (! ok)
+        return false;
 
-void MdaAmbienceAudioProcessor::setCurrentProgram (int index)
-{
+    state = st;
+    rdy = 1; // the buffers are valid for the current size, don't flush them
+    return true;
 }
 
-const juce::String MdaAmbienceAudioProcessor::getProgramName (int index)
-{
-    return {};
-}
+// recalculate the coefficients depending on the changed parameters,
+// called off the audio thread
+void MdaAmbienceAudioProcessor::update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const {
+    c.fbak = 0.8f;
 
-void MdaAmbienceAudioProcessor::changeProgramName (int index, const juce::String& newName)
-{
-}
+    if (changed & dirtyBit(kHf)) {
+        c.damp = 0.05f + 0.9f * values[kHf];
+    }
 
-//==============================================================================
-void MdaAmbienceAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
-{
-    parametersChanged.store(true);
-    reset();
+    if (changed & (dirtyBit(kMix) | dirtyBit(kOutput))) {
+        auto mixValue = values[kMix];
+        float tmp = mda::outputLevelToGain(parameters[kOutput].convertFrom0to1(values[kOutput]));
+        c.dry = tmp - mixValue * mixValue* tmp;
+        c.wet = (0.4f + 0.4f) * mixValue * tmp;
+    }
+
+    if (changed & dirtyBit(kSize)) {
+        c.size = 0.025f + 2.665f * values[kSize];
+        c.decay = 379.0f * c.size * std::log(0.001f) / std::log(c.fbak) / fs;
+    }
 }
 
-void MdaAmbienceAudioProcessor::reset()
-{
-    fil = 0.0f;
-    den = pos = 0;
-    memset(buf1, 0, 1024 * sizeof(float));
-    memset(buf2, 0, 1024 * sizeof(float));
-    memset(buf3, 0, 1024 * sizeof(float));
-    memset(buf4, 0, 1024 * sizeof(float));
-    rdy = 1;
+// audio thread: start ramping towards a new snapshot, over the usual
+// smoothing time unless rampSamples is given
+void MdaAmbienceAudioProcessor::applyCoefficients(const Coefficients& c, int rampSamples) {
+    fbak = c.fbak;
+    if (rampSamples < 0) {
+        dampSmoother.setTargetValue(c.damp);
+        wetSmoother.setTargetValue(c.wet);
+        drySmoother.setTargetValue(c.dry);
+    } else {
+        dampSmoother.setTargetValue(c.damp, rampSamples);
+        wetSmoother.setTargetValue(c.wet, rampSamples);
+        drySmoother.setTargetValue(c.dry, rampSamples);
+    }
+
+    if(size!=c.size) rdy=0;  //need to flush buffer
+    size = c.size;
+    decay = c.decay;
 }
 
-void MdaAmbienceAudioProcessor::releaseResources()
+void MdaAmbienceAudioProcessor::beginBlock()
 {
-    //reset();
+    if (rdy==0) reset();
 }
 
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool MdaAmbienceAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+void MdaAmbienceAudioProcessor::endBlock()
 {
-  #if JucePlugin_IsMidiEffect
-    juce::ignoreUnused (layouts);
-    return true;
-  #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
-
-   #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-   #endif
-
-    return true;
-  #endif
+    //catch denormals, flushing the buffers only once per silence
+    if (state.fil==0.0 && state.den==0)
+    {
+        reset();
+        state.den=1;
+    }
 }
-#endif
 
-void MdaAmbienceAudioProcessor::update(float fs) {
-    // get normalised values
-    auto sizeValue = apvts.getParameter("size")->getValue();
-    auto hfValue = apvts.getParameter("hf")->getValue();
-    auto mixValue = apvts.getParameter("mix")->getValue();
-    auto outputValue = apvts.getParameter("output")->getValue();
-    
-    fbak = 0.8f;
-    damp = 0.05f + 0.9f * hfValue;
-    float tmp = (float)pow(10.0f, 2.0f * outputValue - 1.0f);
-    dry = tmp - mixValue * mixValue* tmp;
-    wet = (0.4f + 0.4f) * mixValue * tmp;
-
-    tmp = 0.025f + 2.665f * sizeValue;
-    if(size!=tmp) rdy=0;  //need to flush buffer
-    size = tmp;
+// the decay time (s) & reverb tail level for the editor
+void MdaAmbienceAudioProcessor::pushMeters (int numSamples)
+{
+    meters.push(numSamples, decay, tailPeak);
 }
 
-void MdaAmbienceAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+// a mono output skips the last allpass, which only feeds the right channel
+template <typename SampleType, mda::ChannelLayout layout, bool hq>
+void MdaAmbienceAudioProcessor::processChannels (juce::AudioBuffer<SampleType>& buffer, int numSamples)
 {
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-
-    auto mainInputOutput = getBusBuffer (buffer, true, 0);
-
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
-    
-    auto fs = (float)getSampleRate();
-    bool expected = true;
-    if (parametersChanged.compare_exchange_strong(expected, false)) {
-        update(fs);
-    }
-    
-    float a, b, c, d, r;
-    float t, f=fil, fb=fbak, dmp=damp, y=dry, w=wet;
-    long  p=pos, d1, d2, d3, d4;
+    constexpr bool stereoIn = layout == mda::ChannelLayout::stereo;
+    constexpr bool stereoOut = layout != mda::ChannelLayout::mono;
 
-    if (rdy==0) reset();
+    auto st = state;
+    SampleType a, b, c, d = 0, r = 0, t, f=(SampleType)st.fil;
+    float tail = 0.0f, fb=fbak, dmp, y, w;
+    long  p=st.pos, d1, d2, d3, d4, d5 = 0, d6 = 0;
 
     d1 = (p + (long)(107 * size)) & 1023;
     d2 = (p + (long)(142 * size)) & 1023;
     d3 = (p + (long)(277 * size)) & 1023;
     d4 = (p + (long)(379 * size)) & 1023;
-    
-    for (auto samp=0; samp < buffer.getNumSamples(); samp++)
+    if constexpr (hq) {
+        d5 = (p + (long)(61 * size)) & 1023;
+        d6 = (p + (long)(83 * size)) & 1023;
+    }
+
+    auto* in1 = buffer.getReadPointer (0);
+    auto* in2 = stereoIn ? buffer.getReadPointer (1) : nullptr;
+    auto* out1 = buffer.getWritePointer (0);
+    auto* out2 = stereoOut ? buffer.getWritePointer (1) : nullptr;
+
+    for (auto start = 0; start < numSamples; start += kSubBlockSize)
     {
-        a = *mainInputOutput.getReadPointer (0, samp);
-        b = *mainInputOutput.getReadPointer (1, samp);
-        c = a;
-        d = b;
-        
-        f += dmp * (w * (a + b) - f); //HF damping
-        r = f;
-
-        t = *(buf1 + p);
-        r -= fb * t;
-        *(buf1 + d1) = r; //allpass
-        r += t;
-
-        t = *(buf2 + p);
-        r -= fb * t;
-        *(buf2 + d2) = r; //allpass
-        r += t;
-        
-        t = *(buf3 + p);
-        r -= fb * t;
-        *(buf3 + d3) = r; //allpass
-        r += t;
-        c += y * a + r - f; //left output
-
-        t = *(buf4 + p);
-        r -= fb * t;
-        *(buf4 + d4) = r; //allpass
-        r += t;
-        d += y * b + r - f; //right output
-
-        ++p  &= 1023;
-        ++d1 &= 1023;
-        ++d2 &= 1023;
-        ++d3 &= 1023;
-        ++d4 &= 1023;
-        
+        auto todo = juce::jmin (kSubBlockSize, numSamples - start);
+        dampSmoother.render (dampRamp, todo);
+        wetSmoother.render (wetRamp, todo);
+        drySmoother.render (dryRamp, todo);
+
+        for (auto j = 0; j < todo; j++)
+        {
+            auto samp = start + j;
+            a = in1[samp];
+            b = stereoIn ? in2[samp] : a; // a mono source feeds both sides
+            c = a;
+            d = b;
+            dmp = dampRamp[j];
+            w = wetRamp[j];
+            y = dryRamp[j];
+
+            f += dmp * (w * (a + b) - f); //HF damping
+            r = f;
+
+            if constexpr (hq) {
+                // two short diffusers ahead of the chain thicken the early echoes
+                t = *(buf5 + p);
+                r -= fb * t;
+                *(buf5 + d5) = (float)r; //allpass
+                r += t;
+
+                t = *(buf6 + p);
+                r -= fb * t;
+                *(buf6 + d6) = (float)r; //allpass
+                r += t;
+            }
+
+            t = *(buf1 + p);
+            r -= fb * t;
+            *(buf1 + d1) = (float)r; //allpass
+            r += t;
+
+            t = *(buf2 + p);
+            r -= fb * t;
+            *(buf2 + d2) = (float)r; //allpass
+            r += t;
+
+            t = *(buf3 + p);
+            r -= fb * t;
+            *(buf3 + d3) = (float)r; //allpass
+            r += t;
+            c += y * a + r - f; //left output
+
+            if constexpr (stereoOut) {
+                t = *(buf4 + p);
+                r -= fb * t;
+                *(buf4 + d4) = (float)r; //allpass
+                r += t;
+                d += y * b + r - f; //right output
+            }
+
+            ++p  &= 1023;
+            ++d1 &= 1023;
+            ++d2 &= 1023;
+            ++d3 &= 1023;
+            ++d4 &= 1023;
+            if constexpr (hq) {
+                ++d5 &= 1023;
+                ++d6 &= 1023;
+            }
+
 #ifdef DEBUG
-        checkSample(c);
-        checkSample(d);
+            mda::checkSample(c);
+            mda::checkSample(d);
 #endif
-        *mainInputOutput.getWritePointer (0, samp) = c;
-        *mainInputOutput.getWritePointer (1, samp) = d;
-    }
-    pos=p;
-    //catch denormals
-    if (fabs(f)>1.0e-10)
-    {
-        fil=f;
-        den=0;
-    }
-    else
-    {
-        fil=0.0f;
-        if (den==0) {
-            den=1;
-            reset();
+            out1[samp] = c;
+            if constexpr (stereoOut) {
+                out2[samp] = d;
+            }
         }
+        tail = juce::jmax(tail, (float)std::abs(r - f)); // sampled once per sub-block
+    }
+    st.pos=p;
+    if (std::abs(f)>(SampleType)1.0e-10) {
+        st.fil=f;
+        st.den=0;
+    } else {
+        st.fil=0.0;
     }
+    state=st;
+    tailPeak=tail;
 }
 
 //==============================================================================
-bool MdaAmbienceAudioProcessor::hasEditor() const
-{
-    return true; // (change this to false if you choose to not supply an editor)
-}
-
 juce::AudioProcessorEditor* MdaAmbienceAudioProcessor::createEditor()
 {
     return new MdaAmbienceAudioProcessorEditor (*this, apvts);
 }
 
-//==============================================================================
-void MdaAmbienceAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
-{
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml (state.createXml());
-    copyXmlToBinary (*xml, destData);
-}
-
-void MdaAmbienceAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
-{
-    std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
-    if (xmlState.get() != nullptr) {
-        if (xmlState->hasTagName (apvts.state.getType())) {
-            apvts.replaceState (juce::ValueTree::fromXml (*xmlState));
-        }
-    }
-}
-
 //==============================================================================
 // This creates new instances of the plugin..
+// (left out when the processors are built into a host such as mdaBenchmark)
+#if ! MDA_EMBEDDED_PLUGINS
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new MdaAmbienceAudioProcessor();
 }
-
-juce::AudioProcessorValueTreeState::ParameterLayout MdaAmbienceAudioProcessor::createParameterLayout()
-{
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(ParameterID::size,
-                                                           "Size",
-                                                           juce::NormalisableRange<float>(0.0f, 10.0f, 0.1f),
-                                                           7.0f,
-                                                           juce::AudioParameterFloatAttributes().withLabel("m")));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(ParameterID::hf,
-                                                           "HF Damping",
-                                                           juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f),
-                                                           70.0f,
-                                                           juce::AudioParameterFloatAttributes().withLabel("%")));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(ParameterID::mix,
-                                                           "Mix",
-                                                           juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f),
-                                                           70.0f,
-                                                           juce::AudioParameterFloatAttributes().withLabel("%")));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(ParameterID::output,
-                                                           "Output Level",
-                                                           juce::NormalisableRange<float>(-24.0f, 6.0f, 0.1f),
-                                                           0.0f,
-                                                           juce::AudioParameterFloatAttributes().withLabel("dB")));
-    
-    return layout;
-}
+#endif
@@ -10,80 +10,113 @@
 
 #include <JuceHeader.h>
 
+//==============================================================================
+// compile-time description of the plugin, see mda::Processor
+struct MdaAmbienceDescription
+{
+    static constexpr const char* name = "mdaAmbience";
+    static constexpr const char* stateTag = "mdAm"; // identifies our binary state
+
+    // parameter indices, in the order of the table below
+    enum ParameterIndex
+    {
+        kSize, kHf, kMix, kOutput,
+        kNumParameters
+    };
+
+    static constexpr mda::ParameterSpec parameters[] =
+    {
+        //  id        name             min    max     step   default  label
+        { "size",     "Size",          0.0f,  10.0f,  0.1f,   7.0f,   "m" },
+        { "hf",       "HF Damping",    0.0f,  100.0f, 1.0f,  70.0f,   "%" },
+        { "mix",      "Mix",           0.0f,  100.0f, 1.0f,  70.0f,   "%" },
+        { "output",   "Output Level", -24.0f, 6.0f,   0.1f,   0.0f,   "dB" },
+    };
+
+    // the first program is the original mda one, the others were added for this port
+    static constexpr mda::Program<kNumParameters> programs[] =
+    {
+        //  name                      size   hf     mix    output
+        { "Small Space Ambience",   { 0.70f, 0.70f, 0.90f, 0.80f } },
+        { "Vocal Booth",            { 0.25f, 0.50f, 0.60f, 0.80f } },
+        { "Bright Room",            { 0.60f, 0.20f, 0.70f, 0.80f } },
+        { "Dark Space",             { 1.00f, 0.90f, 0.80f, 0.80f } },
+        { "Subtle Width",           { 0.45f, 0.60f, 0.35f, 0.80f } },
+    };
+
+    // everything update() derives from the parameters, as one immutable snapshot
+    struct Coefficients
+    {
+        float fbak, damp; // allpass feedback, HF damping
+        float wet, dry; // including output level
+        float size; // allpass delay scaling
+        float decay; // seconds for the longest allpass to fall by 60dB, for display
+    };
+};
+
 //==============================================================================
 /**
 */
-class MdaAmbienceAudioProcessor  : public juce::AudioProcessor
+class MdaAmbienceAudioProcessor  : public mda::Processor<MdaAmbienceAudioProcessor, MdaAmbienceDescription>
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
-                            , private juce::ValueTree::Listener
 {
 public:
     //==============================================================================
     MdaAmbienceAudioProcessor();
     ~MdaAmbienceAudioProcessor() override;
 
-    //==============================================================================
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-   #ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
-   #endif
-
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    //==============================================================================
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    //==============================================================================
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
-
-    //==============================================================================
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
-
-    juce::AudioProcessorValueTreeState apvts { *this, nullptr, "Parameters", createParameterLayout() };
 
     void reset() override;
-    
-private:
-    
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    void valueTreePropertyChanged(juce::ValueTree&, const juce::Identifier&) override
-    {
-        parametersChanged.store(true);
-    }
-    std::atomic<bool> parametersChanged { false };
-    
-    juce::AudioParameterFloat* sizeParam;
-    juce::AudioParameterFloat* hfParam;
-    juce::AudioParameterFloat* mixParam;
-    juce::AudioParameterFloat* outputParam;
+private:
+    friend class mda::Processor<MdaAmbienceAudioProcessor, MdaAmbienceDescription>;
 
+    // the allpass delays, 1024 samples each, in one block allocated by prepareToPlay
+    static constexpr size_t kAllpassSize = 1024;
+    mda::DspBuffer<float> allpassBuffers;
     float *buf1 = nullptr;
     float *buf2 = nullptr;
     float *buf3 = nullptr;
     float *buf4 = nullptr;
-    float fil, fbak, damp, wet, dry, size;
-    long  pos, den, rdy;
-    
-    void update(float fs);
+    float *buf5 = nullptr; // extra diffusers, only allocated when rendering in high quality
+    float *buf6 = nullptr;
+    // damping and mix gains ramp per sample, output level is part of wet & dry
+    mda::RampedValue dampSmoother, wetSmoother, drySmoother;
+    float dampRamp[kSubBlockSize], wetRamp[kSubBlockSize], dryRamp[kSubBlockSize];
+
+    // everything the sample loop carries from one block to the next, loaded into
+    // registers at the start of a block and written back with a single copy
+    struct State
+    {
+        double fil = 0.0; // HF damping, double so double hosts keep full precision
+        long pos = 0; // allpass position
+        long den = 0; // set once the buffers have been flushed after going silent
+    };
+    State state;
+
+    float fbak = 0.8f, size = 0.0f, decay = 0.0f;
+    float tailPeak = 0.0f; // diffuse tail level of the last block, for the meters
+    long rdy = 0;
+
+    // mda::Processor hooks
+    void prepareResources(double sampleRate, int maximumBlockSize);
+    void prepareSmoothing(double sampleRate);
+    void beginBlock();
+    void endBlock();
+    void pushMeters(int numSamples);
+    size_t dspHeapBytes() const noexcept { return allpassBuffers.getHeapBytes(); }
+    void saveDspState(mda::DspStateWriter& writer) const;
+    bool loadDspState(mda::DspStateReader& reader);
+    void update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const;
+    void applyCoefficients(const Coefficients& c, int rampSamples);
+
+    // highQuality is set for offline renders: two extra allpasses for denser diffusion
+    template <typename SampleType, mda::ChannelLayout layout, bool hq>
+    void processChannels(juce::AudioBuffer<SampleType>& buffer, int numSamples);
     
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaAmbienceAudioProcessor)
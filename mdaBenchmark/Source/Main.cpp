@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+    Times what a host does when it scans plugins or loads a session:
+    construct, prepareToPlay and destroy, and measures the heap each
+    instance costs after construction and after prepareToPlay. With --lpc
+    it also times one TalkBox analysis frame per LPC order, with the direct
+    and the FFT autocorrelation, and with --oscillators the oscillator bank
+    behind Shepard for 4 to 16 partials.
+
+      mdaBenchmark [--instances=100] [--rate=48000] [--block=512] [--lpc] [--oscillators]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../mdaDubDelay/Source/PluginProcessor.h"
+#include "../../mdaAmbience/Source/PluginProcessor.h"
+#include "../../mdaTalkBox/Source/PluginProcessor.h"
+#include "../../mdaShepard/Source/PluginProcessor.h"
+
+#if JUCE_LINUX
+ #include <malloc.h>
+#elif JUCE_MAC
+ #include <malloc/malloc.h>
+#endif
+
+//==============================================================================
+// bytes in use on the process heap, including what JUCE allocates for the parameters
+static size_t getHeapBytesInUse()
+{
+   #if JUCE_LINUX
+    return (size_t) mallinfo2().uordblks;
+   #elif JUCE_MAC
+    malloc_statistics_t stats;
+    malloc_zone_statistics (nullptr, &stats);
+    return stats.size_in_use;
+   #else
+    return 0;
+   #endif
+}
+
+// mean time per element in microseconds
+template <typename Container, typename Function>
+static double timeEach (Container& items, Function&& function)
+{
+    auto start = juce::Time::getHighResolutionTicks();
+    for (auto& item : items)
+        function (item);
+    auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+    return elapsed * 1.0e6 / (double) items.size();
+}
+
+static juce::String formatBytes (double bytes)
+{
+    if (bytes >= 1024.0 * 1024.0)
+        return juce::String (bytes / (1024.0 * 1024.0), 2) + " MB";
+    return juce::String (bytes / 1024.0, 1) + " kB";
+}
+
+//==============================================================================
+template <typename Processor>
+static void benchmark (int numInstances, double sampleRate, int blockSize)
+{
+    // kept alive throughout, so the shared tables and the coefficient thread
+    // are already set up and not charged to the measured instances
+    auto warmUp = std::make_unique<Processor>();
+    warmUp->setRateAndBufferSizeDetails (sampleRate, blockSize);
+    warmUp->prepareToPlay (sampleRate, blockSize);
+
+    std::vector<std::unique_ptr<Processor>> instances ((size_t) numInstances);
+
+    auto heapBefore = getHeapBytesInUse();
+    auto constructTime = timeEach (instances, [] (auto& p) { p = std::make_unique<Processor>(); });
+    auto heapConstructed = getHeapBytesInUse();
+
+    auto prepareTime = timeEach (instances, [=] (auto& p)
+                                 {
+                                     p->setRateAndBufferSizeDetails (sampleRate, blockSize);
+                                     p->prepareToPlay (sampleRate, blockSize);
+                                 });
+    auto heapPrepared = getHeapBytesInUse();
+    auto reported = instances.front()->getHeapBytes();
+
+    auto destroyTime = timeEach (instances, [] (auto& p)
+                                 {
+                                     p->releaseResources();
+                                     p.reset();
+                                 });
+
+    auto perInstance = [numInstances] (size_t to, size_t from) { return (double) ((juce::int64) to - (juce::int64) from) / numInstances; };
+
+    std::cout << warmUp->getName() << ": construct " << juce::String (constructTime, 1)
+              << " us, prepare " << juce::String (prepareTime, 1)
+              << " us, destroy " << juce::String (destroyTime, 1) << " us per instance" << std::endl
+              << "  heap per instance: " << formatBytes (perInstance (heapConstructed, heapBefore)) << " constructed, "
+              << formatBytes (perInstance (heapPrepared, heapBefore)) << " prepared, "
+              << formatBytes ((double) reported) << " reported by getHeapBytes()" << std::endl;
+}
+
+//==============================================================================
+// microseconds per frame for each order, where the crossover to the FFT shows
+static void benchmarkLpc (double sampleRate)
+{
+    auto frameSize = juce::jmin ((int) (0.01633 * sampleRate), TalkBoxLpc::maxFrameSize);
+    TalkBoxLpc lpc;
+    lpc.prepare (frameSize, TalkBoxLpc::maxOrder);
+
+    // the frame is analysed in place, so every run starts from a copy
+    std::vector<float> modulator ((size_t) (frameSize + TalkBoxLpc::framePadding)), frame (modulator.size()), carrier ((size_t) frameSize);
+    juce::Random random (1234);
+    float smoothed = 0.0f;
+    for (int i = 0; i < frameSize; ++i)
+    {
+        smoothed = 0.9f * smoothed + random.nextFloat() - 0.5f; // some spectral tilt, like a voice
+        modulator[(size_t) i] = smoothed;
+        carrier[(size_t) i] = random.nextFloat() - 0.5f;
+    }
+
+    auto time = [&] (int order, TalkBoxLpc::Method method)
+    {
+        constexpr int numFrames = 1000;
+        auto start = juce::Time::getHighResolutionTicks();
+        for (int n = 0; n < numFrames; ++n)
+        {
+            std::copy (modulator.begin(), modulator.end(), frame.begin());
+            lpc.process (frame.data(), carrier.data(), frameSize, order, method);
+        }
+        return juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start) * 1.0e6 / numFrames;
+    };
+
+    std::cout << "TalkBox LPC, " << frameSize << "-sample frames, two per " << juce::String (2000.0 * frameSize / sampleRate, 1)
+              << " ms; us per frame, direct / FFT autocorrelation:" << std::endl;
+
+    for (int order = 4; order <= TalkBoxLpc::maxOrder; order += 4)
+        std::cout << "  order " << order << ": " << juce::String (time (order, TalkBoxLpc::Method::direct), 2)
+                  << " / " << juce::String (time (order, TalkBoxLpc::Method::fft), 2)
+                  << (order > TalkBoxLpc::fftOrderThreshold ? "  (uses FFT)" : "") << std::endl;
+}
+
+//==============================================================================
+// nanoseconds per sample for each number of partials, and per partial, with
+// the bank retuned every 32 samples as Shepard does
+static void benchmarkOscillators (double sampleRate)
+{
+    constexpr int subBlockSize = 32;
+    constexpr int numSubBlocks = 20000;
+
+    mda::BandLimitedWavetable saw ([] (int n) { return 1.0f / (float) n; });
+    mda::OscillatorBank bank;
+    float output[subBlockSize];
+
+    std::cout << "Oscillator bank, band-limited saws an octave apart; ns per sample, per partial:" << std::endl;
+
+    for (int numPartials = 4; numPartials <= mda::OscillatorBank::maxPartials; numPartials += 4)
+    {
+        bank.setNumPartials (numPartials);
+
+        auto start = juce::Time::getHighResolutionTicks();
+        for (int n = 0; n < numSubBlocks; ++n)
+        {
+            for (int p = 0; p < numPartials; ++p)
+                bank.setPartial (p, saw, (float) (27.5 * std::exp2 (p + (n & 63) / 64.0) / sampleRate), 0.1f);
+            bank.render (output, subBlockSize);
+        }
+        auto ns = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start) * 1.0e9
+                    / (numSubBlocks * subBlockSize);
+
+        std::cout << "  " << numPartials << " partials: " << juce::String (ns, 2)
+                  << " / " << juce::String (ns / numPartials, 2) << std::endl;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+    juce::ScopedJuceInitialiser_GUI juceInitialiser; // the APVTS needs a message manager
+
+    auto option = [&args] (const char* name, double defaultValue)
+    {
+        auto value = args.getValueForOption (name);
+        return value.isEmpty() ? defaultValue : value.getDoubleValue();
+    };
+
+    auto numInstances = juce::jmax (1, (int) option ("--instances", 100));
+    auto sampleRate = option ("--rate", 48000.0);
+    auto blockSize = juce::jmax (1, (int) option ("--block", 512));
+
+    std::cout << numInstances << " instances at " << sampleRate << " Hz, " << blockSize << "-sample blocks" << std::endl;
+
+    benchmark<MdaDubDelayAudioProcessor> (numInstances, sampleRate, blockSize);
+    benchmark<MdaAmbienceAudioProcessor> (numInstances, sampleRate, blockSize);
+    benchmark<MdaTalkBoxAudioProcessor> (numInstances, sampleRate, blockSize);
+    benchmark<MdaShepardAudioProcessor> (numInstances, sampleRate, blockSize);
+
+    if (args.containsOption ("--lpc"))
+        benchmarkLpc (sampleRate);
+
+    if (args.containsOption ("--oscillators"))
+        benchmarkOscillators (sampleRate);
+
+    return 0;
+}
@@ -0,0 +1,10 @@
+/*
+  ==============================================================================
+
+    The mdaShepard processor and editor, built into this app.
+
+  ==============================================================================
+*/
+
+#include "../../mdaShepard/Source/PluginProcessor.cpp"
+#include "../../mdaShepard/Source/PluginEditor.cpp"
@@ -0,0 +1,11 @@
+/*
+  ==============================================================================
+
+    The mdaTalkBox processor, editor and LPC engine, built into this app.
+
+  ==============================================================================
+*/
+
+#include "../../mdaTalkBox/Source/PluginProcessor.cpp"
+#include "../../mdaTalkBox/Source/PluginEditor.cpp"
+#include "../../mdaTalkBox/Source/TalkBoxLpc.cpp"
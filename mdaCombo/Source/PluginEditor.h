@@ -0,0 +1,25 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    The generic layout: one row per parameter, then the level meters.
+*/
+class MdaComboAudioProcessorEditor  : public mda::ProcessorEditor<MdaComboAudioProcessor>
+{
+public:
+    explicit MdaComboAudioProcessorEditor (MdaComboAudioProcessor&);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaComboAudioProcessorEditor)
+};
@@ -0,0 +1,431 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaComboAudioProcessor::MdaComboAudioProcessor()
+{
+    reset();
+}
+
+MdaComboAudioProcessor::~MdaComboAudioProcessor()
+{
+}
+
+//==============================================================================
+template <typename SampleType>
+static void buildOversamplers (std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, (size_t) MdaComboDescription::kMaxOversampling>& oversamplers,
+                               bool maxQuality, int maxBlockSize)
+{
+    for (size_t i = 0; i < oversamplers.size(); ++i) {
+        // polyphase IIR half-band stages, integer latency so the host can compensate exactly
+        oversamplers[i] = std::make_unique<juce::dsp::Oversampling<SampleType>>(2, i + 1, juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR,
+                                                                                 maxQuality, true);
+        oversamplers[i]->initProcessing((size_t)maxBlockSize);
+    }
+}
+
+void MdaComboAudioProcessor::prepareResources (double sampleRate, int maximumBlockSize)
+{
+    maxBlockSize = juce::jmax(1, maximumBlockSize);
+    switchFadeSamples = juce::roundToInt(kSwitchFadeTime * sampleRate);
+
+    // offline renders get the steeper half-band filters
+    if (isUsingDoublePrecision()) {
+        buildOversamplers(doubleOversamplers, highQuality, maxBlockSize);
+        doubleScratch.allocate(2 * (size_t)maxBlockSize);
+        floatOversamplers = {};
+        floatScratch.free();
+    } else {
+        buildOversamplers(floatOversamplers, highQuality, maxBlockSize);
+        floatScratch.allocate(2 * (size_t)maxBlockSize);
+        doubleOversamplers = {};
+        doubleScratch.free();
+    }
+}
+
+void MdaComboAudioProcessor::prepareSmoothing (double sampleRate)
+{
+    for (auto* smoother : { &driveSmoother, &biasSmoother, &trimSmoother }) {
+        smoother->reset(sampleRate, kSmoothingTime);
+    }
+}
+
+// an estimate, unlike the other plugins' figures: juce::dsp::Oversampling doesn't
+// report its allocations, so this counts the two channel stage buffers, one per
+// factor and each stage twice as long as the one before, and leaves out the
+// filter states and the objects themselves
+size_t MdaComboAudioProcessor::estimatedOversamplerBytes() const noexcept
+{
+    auto sampleSize = doubleOversamplers[0] != nullptr ? sizeof(double) : floatOversamplers[0] != nullptr ? sizeof(float) : 0;
+    size_t samples = 0;
+    for (int factor = 1; factor <= kMaxOversampling; ++factor) {
+        for (int stage = 1; stage <= factor; ++stage) {
+            samples += 2 * (size_t)maxBlockSize << stage;
+        }
+    }
+    return samples * sampleSize;
+}
+
+size_t MdaComboAudioProcessor::dspHeapBytes() const noexcept
+{
+    return estimatedOversamplerBytes() + floatScratch.getHeapBytes() + doubleScratch.getHeapBytes();
+}
+
+void MdaComboAudioProcessor::resetOversamplers()
+{
+    for (auto& o : floatOversamplers) {
+        if (o != nullptr) o->reset();
+    }
+    for (auto& o : doubleOversamplers) {
+        if (o != nullptr) o->reset();
+    }
+}
+
+void MdaComboAudioProcessor::reset()
+{
+    speaker.reset();
+    std::memset(hpfState, 0, sizeof(hpfState));
+    resetOversamplers();
+
+    // from silence there is nothing to fade from
+    fadeRemaining = 0;
+    stereoFadeRemaining = 0;
+    processedStereo = true;
+    setOversampling(requestedOversampling);
+}
+
+// the oversamplers' filter states are JUCE's own and not part of the snapshot,
+// they start from silence again, which costs a few samples of their latency
+void MdaComboAudioProcessor::saveDspState (mda::DspStateWriter& writer) const
+{
+    for (auto& channel : hpfState) {
+        writer.write(channel[0]);
+        writer.write(channel[1]);
+    }
+    writer.writeSamples(speaker.getStateData(), speaker.numStateValues);
+}
+
+bool MdaComboAudioProcessor::loadDspState (mda::DspStateReader& reader)
+{
+    float st[2][2];
+    auto ok = reader.read(st[0][0]) && reader.read(st[0][1]) && reader.read(st[1][0]) && reader.read(st[1][1])
+           && reader.readSamples(speaker.getStateData(), speaker.numStateValues);
+
+    if (! ok)
+        return false;
+
+    std::memcpy(hpfState, st, sizeof(hpfState));
+    resetOversamplers();
+    stereoFadeRemaining = 0;
+    processedStereo = true;
+    return true;
+}
+
+// recalculate the coefficients depending on the changed parameters,
+// called off the audio thread
+void MdaComboAudioProcessor::update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const {
+    auto& model = models[juce::roundToInt(parameters[kModel].convertFrom0to1(values[kModel]))];
+
+    if (changed & dirtyBit(kModel)) {
+        // the speaker as a cascade of biquads
+        auto n = 0;
+        c.speaker[n++] = mda::BiquadCoefficients::highPass(fs, model.highPassHz, 0.7071);
+        if (model.lowPassHz > 0.0f) {
+            // 4th order Butterworth, the original had four one-pole sections
+            c.speaker[n++] = mda::BiquadCoefficients::lowPass(fs, model.lowPassHz, 0.5412);
+            c.speaker[n++] = mda::BiquadCoefficients::lowPass(fs, model.lowPassHz, 1.3066);
+        }
+        for (int r = 0; r < 2; ++r) {
+            // the lowest peak of the original comb: half way for a negative mix
+            auto mix = model.resonanceMix[r];
+            if (mix == 0.0f) continue;
+            auto hz = mix < 0.0f ? 0.5f * model.resonanceHz[r] : model.resonanceHz[r];
+            if (hz < 0.45f * fs) {
+                c.speaker[n++] = mda::BiquadCoefficients::peak(fs, hz, 2.0, 1.0 + std::abs(mix));
+            }
+        }
+        c.numSpeakerStages = n;
+    }
+
+    // soft clipping below the centre, hard clipping above
+    auto drive = values[kDrive];
+    auto trim = model.trim;
+    c.softClip = drive < 0.5f;
+    if (c.softClip) {
+        c.drive = std::pow(10.0f, 2.0f - 6.0f * drive);
+        c.clip = 1.0f;
+        trim *= 0.55f + 150.0f * std::pow(drive, 4.0f);
+    } else {
+        c.drive = 1.0f;
+        c.clip = 11.7f - 16.0f * drive;
+        if (drive > 0.7f) {
+            c.drive = std::pow(10.0f, 7.0f * drive - 4.9f);
+            c.clip = 0.5f;
+        }
+        trim /= 0.3f + 0.7f * juce::jmin(c.clip, 1.0f);
+    }
+
+    c.bias = (1.2f * values[kBias] - 0.6f) / (1.0f + 3.0f * std::abs(drive - 0.5f));
+
+    // the resonant high pass ahead of the drive, a state variable filter
+    if (values[kHpfFreq] > 0.0f) {
+        auto hz = juce::jmin(hpfPercentToHz(parameters[kHpfFreq].convertFrom0to1(values[kHpfFreq])), fs / 6.0f);
+        c.hpfFreq = 2.0f * std::sin(juce::MathConstants<float>::pi * hz / fs);
+        c.hpfDamp = 1.1f - values[kHpfReso];
+        c.drive *= 1.0f + 0.1f * juce::jmin(c.drive, 10.0f); // the thinner sound can take more
+    } else {
+        c.hpfFreq = 0.0f;
+        c.hpfDamp = 1.0f;
+    }
+
+    c.trim = trim * juce::Decibels::decibelsToGain(parameters[kOutput].convertFrom0to1(values[kOutput]));
+    c.stereo = values[kProcess] > 0.5f;
+    c.oversampling = juce::roundToInt(parameters[kOversampling].convertFrom0to1(values[kOversampling]));
+}
+
+// audio thread: start ramping towards a new snapshot, over the usual
+// smoothing time unless rampSamples is given
+void MdaComboAudioProcessor::applyCoefficients(const Coefficients& c, int rampSamples) {
+    if (rampSamples < 0) {
+        driveSmoother.setTargetValue(c.drive);
+        biasSmoother.setTargetValue(c.bias);
+        trimSmoother.setTargetValue(c.trim);
+    } else {
+        driveSmoother.setTargetValue(c.drive, rampSamples);
+        biasSmoother.setTargetValue(c.bias, rampSamples);
+        trimSmoother.setTargetValue(c.trim, rampSamples);
+    }
+
+    speaker.setStages(c.speaker, c.numSpeakerStages);
+    softClip = c.softClip;
+    clip = c.clip;
+    hpfFreq = c.hpfFreq;
+    hpfDamp = c.hpfDamp;
+    stereo = c.stereo;
+
+    // picked up by the next block, see processChannels
+    requestedOversampling = juce::jlimit(0, kMaxOversampling - 1, c.oversampling - 1);
+}
+
+// switches to a prepared oversampler, from silence, and tells the host its latency
+void MdaComboAudioProcessor::setOversampling(int index)
+{
+    oversamplingIndex = index;
+
+    float latency = 0.0f;
+    if (auto& o = floatOversamplers[(size_t)oversamplingIndex]) {
+        o->reset();
+        latency = o->getLatencyInSamples();
+    }
+    if (auto& o = doubleOversamplers[(size_t)oversamplingIndex]) {
+        o->reset();
+        latency = (float)o->getLatencyInSamples();
+    }
+    reportLatency(juce::roundToInt(latency));
+}
+
+// Chamberlin state variable filter, high pass output
+template <typename SampleType>
+void MdaComboAudioProcessor::highPass (SampleType* samples, int numSamples, float* state) const noexcept
+{
+    float low = state[0], band = state[1], f = hpfFreq, q = hpfDamp;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        low += f * band;
+        auto high = (float)samples[i] - low - q * band;
+        band += f * high;
+        samples[i] = (SampleType)high;
+    }
+
+    // flush to zero, the filter rings down forever otherwise
+    state[0] = std::abs(low) > 1.0e-10f ? low : 0.0f;
+    state[1] = std::abs(band) > 1.0e-10f ? band : 0.0f;
+}
+
+// the waveshaper at the oversampled rate, drive & bias step per sub-block of the
+// original rate; both curves are branchless so the loops vectorise
+template <typename SampleType>
+void MdaComboAudioProcessor::shape (juce::dsp::AudioBlock<SampleType>& block, int factor, int numSamples,
+                                    mda::RampedValue& drive, mda::RampedValue& bias) noexcept
+{
+    auto numChannels = block.getNumChannels();
+    auto clp = (SampleType)clip;
+
+    for (auto start = 0; start < numSamples; start += kSubBlockSize)
+    {
+        auto todo = juce::jmin(kSubBlockSize, numSamples - start);
+        auto drv = (SampleType)drive.skip(todo);
+        auto bi = (SampleType)bias.skip(todo);
+
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            auto* x = block.getChannelPointer(ch) + start * factor;
+            auto n = todo * factor;
+
+            if (softClip) {
+                for (int i = 0; i < n; ++i) {
+                    auto a = drv * (x[i] + bi);
+                    x[i] = a / ((SampleType)1 + std::abs(a));
+                }
+            } else {
+                for (int i = 0; i < n; ++i) {
+                    x[i] = juce::jlimit(-clp, clp, drv * (x[i] + bi));
+                }
+            }
+        }
+    }
+}
+
+// up, shape, down, in place
+template <typename SampleType>
+void MdaComboAudioProcessor::oversample (juce::dsp::Oversampling<SampleType>& oversampler, juce::dsp::AudioBlock<SampleType>& block,
+                                         int numSamples, mda::RampedValue& drive, mda::RampedValue& bias) noexcept
+{
+    // the oversampler's buffers always have two channels, only shape the ones in use
+    auto upsampled = oversampler.processSamplesUp(block).getSubsetChannelBlock(0, block.getNumChannels());
+    shape(upsampled, (int)oversampler.getOversamplingFactor(), numSamples, drive, bias);
+    oversampler.processSamplesDown(block);
+}
+
+// high pass, then drive oversampled, then the speaker and trim at the host rate;
+// a mono mix runs everything once and copies it to a stereo output
+template <typename SampleType, mda::ChannelLayout layout, bool hq>
+void MdaComboAudioProcessor::processChannels (juce::AudioBuffer<SampleType>& buffer, int numSamples)
+{
+    constexpr bool stereoIn = layout == mda::ChannelLayout::stereo;
+    constexpr bool stereoOut = layout != mda::ChannelLayout::mono;
+
+    auto numProcessed = (stereoIn && stereo) ? 2 : 1;
+    SampleType* channels[2] = { buffer.getWritePointer(0), numProcessed > 1 ? buffer.getWritePointer(1) : nullptr };
+
+    if (stereoIn && numProcessed == 1) {
+        // averaged, so a centred source drives the same as in stereo
+        auto* right = buffer.getReadPointer(1);
+        for (int i = 0; i < numSamples; ++i) {
+            channels[0][i] = (SampleType)0.5 * (channels[0][i] + right[i]);
+        }
+    }
+
+    if (numProcessed > 1 && ! processedStereo) {
+        // channel 1's filters start where channel 0's are, and its oversampler's
+        // stale state is hidden under a fade from channel 0's output, which is
+        // what the right output was playing
+        std::copy(hpfState[0], hpfState[0] + 2, hpfState[1]);
+        speaker.copyLeftToRight();
+        stereoFadeRemaining = switchFadeSamples;
+    }
+    processedStereo = numProcessed > 1;
+
+    auto& oversamplers = getOversamplers<SampleType>();
+    if (requestedOversampling != oversamplingIndex && fadeRemaining == 0) {
+        // the new factor starts from silence, faded in over the old one
+        fadeFromIndex = oversamplingIndex;
+        fadeRemaining = switchFadeSamples;
+        setOversampling(requestedOversampling);
+    }
+
+    for (auto start = 0; start < numSamples; start += maxBlockSize)
+    {
+        auto todo = juce::jmin(maxBlockSize, numSamples - start);
+        SampleType* chunk[2] = { channels[0] + start, numProcessed > 1 ? channels[1] + start : nullptr };
+
+        if (hpfFreq > 0.0f) {
+            for (auto ch = 0; ch < numProcessed; ++ch) {
+                highPass(chunk[ch], todo, hpfState[ch]);
+            }
+        }
+
+        juce::dsp::AudioBlock<SampleType> block (chunk, (size_t)numProcessed, (size_t)todo);
+
+        if (fadeRemaining > 0) {
+            // the outgoing factor on a copy, with the same drive & bias ramps
+            auto* scratch = getScratch<SampleType>();
+            SampleType* faded[2] = { scratch, scratch + maxBlockSize };
+            for (auto ch = 0; ch < numProcessed; ++ch) {
+                std::copy(chunk[ch], chunk[ch] + todo, faded[ch]);
+            }
+            auto drive = driveSmoother, bias = biasSmoother;
+            juce::dsp::AudioBlock<SampleType> fadedBlock (faded, (size_t)numProcessed, (size_t)todo);
+            oversample(*oversamplers[(size_t)fadeFromIndex], fadedBlock, todo, drive, bias);
+            oversample(*oversamplers[(size_t)oversamplingIndex], block, todo, driveSmoother, biasSmoother);
+
+            auto n = juce::jmin(todo, fadeRemaining);
+            auto done = switchFadeSamples - fadeRemaining;
+            auto scale = (SampleType)1 / (SampleType)switchFadeSamples;
+            for (auto ch = 0; ch < numProcessed; ++ch) {
+                auto* x = chunk[ch];
+                auto* y = faded[ch];
+                for (auto j = 0; j < n; ++j) {
+                    auto g = (SampleType)(done + j + 1) * scale;
+                    x[j] = y[j] + g * (x[j] - y[j]);
+                }
+            }
+            fadeRemaining -= n;
+        } else {
+            oversample(*oversamplers[(size_t)oversamplingIndex], block, todo, driveSmoother, biasSmoother);
+        }
+
+        // both channels through the same biquads at once
+        speaker.process(chunk[0], chunk[1], todo);
+
+        for (auto sub = 0; sub < todo; sub += kSubBlockSize)
+        {
+            auto n = juce::jmin(kSubBlockSize, todo - sub);
+            trimSmoother.render(trimRamp, n);
+
+            for (auto ch = 0; ch < numProcessed; ++ch) {
+                auto* x = chunk[ch] + sub;
+                for (auto j = 0; j < n; ++j) {
+                    x[j] *= (SampleType)trimRamp[j];
+#ifdef DEBUG
+                    mda::checkSample(x[j]);
+#endif
+                }
+            }
+        }
+
+        if (stereoFadeRemaining > 0 && numProcessed > 1) {
+            auto n = juce::jmin(todo, stereoFadeRemaining);
+            auto done = switchFadeSamples - stereoFadeRemaining;
+            auto scale = (SampleType)1 / (SampleType)switchFadeSamples;
+            auto* x = chunk[1];
+            auto* y = chunk[0];
+            for (auto j = 0; j < n; ++j) {
+                auto g = (SampleType)(done + j + 1) * scale;
+                x[j] = y[j] + g * (x[j] - y[j]);
+            }
+            stereoFadeRemaining -= n;
+        }
+    }
+
+    if constexpr (stereoOut) {
+        if (numProcessed == 1) {
+            buffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
+        }
+    }
+}
+
+//==============================================================================
+juce::AudioProcessorEditor* MdaComboAudioProcessor::createEditor()
+{
+    return new MdaComboAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+// (left out when the processors are built into a host such as mdaBenchmark)
+#if ! MDA_EMBEDDED_PLUGINS
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new MdaComboAudioProcessor();
+}
+#endif
@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// compile-time description of the plugin, see mda::Processor
+struct MdaComboDescription
+{
+    static constexpr const char* name = "mdaCombo";
+    static constexpr const char* stateTag = "mdCo"; // identifies our binary state
+
+    // the original mda models: a trim, the speaker's low & high pass corners and
+    // two cabinet resonances, which were comb filters and are now peaking biquads
+    struct SpeakerModel
+    {
+        const char* name;
+        float trim, lowPassHz, highPassHz; // no low pass at 0
+        float resonanceHz[2], resonanceMix[2];
+    };
+
+    static constexpr SpeakerModel models[] =
+    {
+        //  name          trim   low pass  high pass  resonances         mix
+        { "D.I.",         0.50f,    0.0f,    25.0f, {    0.0f,    0.0f }, {  0.00f, 0.00f } },
+        { "Spkr Sim",     0.53f, 2700.0f,   382.0f, {    0.0f,    0.0f }, {  0.00f, 0.00f } },
+        { "Radio",        1.10f, 1685.0f,    25.0f, { 6546.0f, 4315.0f }, { -1.70f, 0.82f } },
+        { "MB 1\"",       0.98f, 1385.0f,    25.0f, { 7345.0f, 1193.0f }, { -0.53f, 0.21f } },
+        { "MB 8\"",       0.96f, 1685.0f,    25.0f, { 6546.0f, 3315.0f }, { -0.85f, 0.41f } },
+        { "4x12 ^",       0.59f, 2795.0f,   459.0f, {  982.0f, 2402.0f }, { -0.29f, 0.38f } },
+        { "4x12 >",       0.30f, 1744.0f,   382.0f, {  356.0f, 1263.0f }, { -0.96f, 1.60f } },
+    };
+    static constexpr int kNumModels = (int) std::size (models);
+
+    // high pass, two low pass sections for 24dB/oct, two resonances
+    static constexpr int kMaxSpeakerStages = 5;
+
+    static constexpr int kMaxOversampling = 3; // 2^3 = 8x
+
+    // parameter indices, in the order of the table below
+    enum ParameterIndex
+    {
+        kModel, kDrive, kBias, kOutput, kProcess, kHpfFreq, kHpfReso, kOversampling,
+        kNumParameters
+    };
+
+    static juce::String modelToText(float value, int)
+    {
+        return models[juce::jlimit(0, kNumModels - 1, juce::roundToInt(value))].name;
+    }
+
+    static juce::String processToText(float value, int)
+    {
+        return value < 0.5f ? "Mono" : "Stereo";
+    }
+
+    // the resonant input high pass sweeps 30Hz to 7.7kHz, off at 0
+    static float hpfPercentToHz(float percent)
+    {
+        return 30.0f * std::exp2(0.08f * percent);
+    }
+
+    static juce::String hpfFreqToText(float value, int)
+    {
+        return value <= 0.0f ? juce::String("Off") : juce::String(juce::roundToInt(hpfPercentToHz(value))) + " Hz";
+    }
+
+    static juce::String oversamplingToText(float value, int)
+    {
+        return juce::String(1 << juce::roundToInt(value)) + "x";
+    }
+
+    static constexpr mda::ParameterSpec parameters[] =
+    {
+        //  id              name            min      max                     step   default  label
+        { "model",          "Model",        0.0f,    (float)(kNumModels - 1), 1.0f,  6.0f,   "", modelToText },
+        // soft clipping to the left, hard clipping to the right
+        { "drive",          "Drive",     -100.0f,  100.0f,                   1.0f,   0.0f,   "%" },
+        { "bias",           "Bias",      -100.0f,  100.0f,                   1.0f,   0.0f,   "%" },
+        { "output",         "Output Level", -20.0f, 20.0f,                   0.1f,   0.0f,   "dB" },
+        { "process",        "Process",      0.0f,    1.0f,                   1.0f,   0.0f,   "", processToText },
+        { "hpfFreq",        "HPF Freq",     0.0f,  100.0f,                   1.0f,   0.0f,   "", hpfFreqToText },
+        { "hpfReso",        "HPF Reso",     0.0f,  100.0f,                   1.0f,  50.0f,   "%" },
+        { "oversampling",   "Oversampling", 1.0f,  (float)kMaxOversampling,  1.0f,   2.0f,   "", oversamplingToText },
+    };
+
+    // the first program is the original mda one, the others were added for this port
+    static constexpr mda::Program<kNumParameters> programs[] =
+    {
+        //  name                          model    drive  bias   output process hpf    reso   oversampling
+        { "Amp & Speaker Simulator",    { 1.000f,  0.50f, 0.50f, 0.50f, 0.0f,   0.00f, 0.50f, 0.5f } },
+        { "Warm D.I.",                  { 0.000f,  0.35f, 0.55f, 0.50f, 1.0f,   0.00f, 0.50f, 0.5f } },
+        { "Transistor Radio",           { 0.333f,  0.80f, 0.50f, 0.50f, 0.0f,   0.30f, 0.60f, 0.5f } },
+        { "Boogie Crunch",              { 0.500f,  0.70f, 0.60f, 0.45f, 1.0f,   0.10f, 0.40f, 0.5f } },
+        { "Speaker Only",               { 0.167f,  0.50f, 0.50f, 0.50f, 1.0f,   0.00f, 0.50f, 0.5f } },
+        { "Scooped Stack",              { 0.833f,  0.90f, 0.40f, 0.40f, 1.0f,   0.20f, 0.50f, 1.0f } },
+    };
+
+    // everything update() derives from the parameters, as one immutable snapshot
+    struct Coefficients
+    {
+        mda::BiquadCoefficients speaker[kMaxSpeakerStages]; // model response
+        int numSpeakerStages;
+        bool softClip;
+        float drive, bias, clip; // waveshaper, at the oversampled rate
+        float trim; // model trim, drive compensation & output level
+        float hpfFreq, hpfDamp; // input state variable high pass, off at 0
+        bool stereo;
+        int oversampling; // log2 of the factor
+    };
+};
+
+//==============================================================================
+/**
+*/
+class MdaComboAudioProcessor  : public mda::Processor<MdaComboAudioProcessor, MdaComboDescription>
+                            #if JucePlugin_Enable_ARA
+                             , public juce::AudioProcessorARAExtension
+                            #endif
+{
+public:
+    //==============================================================================
+    MdaComboAudioProcessor();
+    ~MdaComboAudioProcessor() override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+
+    void reset() override;
+
+private:
+    friend class mda::Processor<MdaComboAudioProcessor, MdaComboDescription>;
+
+    // one oversampler per factor, built in prepareToPlay for the precision the
+    // host processes in, so switching the factor never allocates
+    template <typename SampleType>
+    using Oversamplers = std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, (size_t) kMaxOversampling>;
+    Oversamplers<float> floatOversamplers;
+    Oversamplers<double> doubleOversamplers;
+    int oversamplingIndex = 1, requestedOversampling = 1;
+    int maxBlockSize = 0; // the oversamplers' buffers, longer host blocks are split
+
+    // a new factor fades in over the old one, which runs on a copy of the input
+    // until the fade is done
+    static constexpr double kSwitchFadeTime = 0.01; // in seconds
+    mda::DspBuffer<float> floatScratch;
+    mda::DspBuffer<double> doubleScratch;
+    int switchFadeSamples = 0, fadeRemaining = 0, fadeFromIndex = 0;
+
+    // channel 1 sits out while the input is mixed to mono, and when Process goes
+    // back to stereo its output fades in from channel 0's over the same time
+    int stereoFadeRemaining = 0;
+    bool processedStereo = true;
+
+    template <typename SampleType>
+    Oversamplers<SampleType>& getOversamplers() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return floatOversamplers;
+        else
+            return doubleOversamplers;
+    }
+
+    template <typename SampleType>
+    SampleType* getScratch() const noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return floatScratch.get();
+        else
+            return doubleScratch.get();
+    }
+
+    mda::StereoBiquadCascade<kMaxSpeakerStages> speaker;
+
+    // drive & bias step once per sub-block, the output trim ramps per sample
+    mda::RampedValue driveSmoother, biasSmoother, trimSmoother;
+    float trimRamp[kSubBlockSize];
+
+    float hpfState[2][2] {}; // low & band per channel
+    float hpfFreq = 0.0f, hpfDamp = 1.0f;
+    float clip = 1.0f;
+    bool softClip = false, stereo = false;
+
+    // mda::Processor hooks
+    void prepareResources(double sampleRate, int maximumBlockSize);
+    void prepareSmoothing(double sampleRate);
+    size_t dspHeapBytes() const noexcept;
+    void saveDspState(mda::DspStateWriter& writer) const;
+    bool loadDspState(mda::DspStateReader& reader);
+    void update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const;
+    void applyCoefficients(const Coefficients& c, int rampSamples);
+
+    void setOversampling(int index);
+    size_t estimatedOversamplerBytes() const noexcept;
+    void resetOversamplers();
+
+    template <typename SampleType>
+    void highPass(SampleType* samples, int numSamples, float* state) const noexcept;
+    template <typename SampleType>
+    void shape(juce::dsp::AudioBlock<SampleType>& block, int factor, int numSamples,
+               mda::RampedValue& drive, mda::RampedValue& bias) noexcept;
+    template <typename SampleType>
+    void oversample(juce::dsp::Oversampling<SampleType>& oversampler, juce::dsp::AudioBlock<SampleType>& block,
+                    int numSamples, mda::RampedValue& drive, mda::RampedValue& bias) noexcept;
+
+    // highQuality (offline renders) only picks the sharper oversampling filters in prepareToPlay
+    template <typename SampleType, mda::ChannelLayout layout, bool hq>
+    void processChannels(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaComboAudioProcessor)
+};
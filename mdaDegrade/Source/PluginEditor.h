@@ -0,0 +1,25 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    The generic layout: one row per parameter and the level meters.
+*/
+class MdaDegradeAudioProcessorEditor  : public mda::ProcessorEditor<MdaDegradeAudioProcessor>
+{
+public:
+    explicit MdaDegradeAudioProcessorEditor (MdaDegradeAudioProcessor&);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaDegradeAudioProcessorEditor)
+};
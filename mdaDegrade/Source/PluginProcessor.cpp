@@ -0,0 +1,251 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaDegradeAudioProcessor::MdaDegradeAudioProcessor()
+{
+    reset();
+}
+
+MdaDegradeAudioProcessor::~MdaDegradeAudioProcessor()
+{
+}
+
+//==============================================================================
+void MdaDegradeAudioProcessor::prepareSmoothing (double sampleRate)
+{
+    gainSmoother.reset(sampleRate, kSmoothingTime);
+}
+
+void MdaDegradeAudioProcessor::reset()
+{
+    state = {};
+}
+
+// the live state for the optional snapshot in the saved state, in a fixed order
+void MdaDegradeAudioProcessor::saveDspState (mda::DspStateWriter& writer) const
+{
+    auto& st = state;
+    writer.write(st.remaining);
+    writer.write(st.sum);
+    writer.write(st.held);
+    for (auto v : st.lp) {
+        writer.write(v);
+    }
+}
+
+bool MdaDegradeAudioProcessor::loadDspState (mda::DspStateReader& reader)
+{
+    State st;
+    auto ok = reader.read(st.remaining) && reader.read(st.sum) && reader.read(st.held)
+           && st.remaining > 0;
+    for (auto& v : st.lp) {
+        ok = ok && reader.read(v);
+    }
+
+    if (! ok)
+        return false;
+
+    state = st;
+    return true;
+}
+
+// recalculate the coefficients depending on the changed parameters,
+// called off the audio thread
+void MdaDegradeAudioProcessor::update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const {
+    auto plain = [&](int i) { return parameters[i].convertFrom0to1(values[i]); };
+
+    auto rate = plain(kRate);
+    c.divisor = rateToDivisor(rate);
+    c.averaging = rate > 0.0f;
+
+    // the mono sum is halved on the way back, 2^bits steps from -1 to 1
+    c.quantise = std::exp2((float)juce::roundToInt(plain(kQuantise)) - 2.0f);
+    c.step = 0.5f / c.quantise;
+
+    // a power curve on one or both halves of the wave, tabulated against the
+    // square root of the level where it is smooth enough to interpolate
+    auto nonLin = plain(kNonLinearity);
+    c.linear = juce::roundToInt(nonLin) == 0;
+    auto bend = std::pow(10.0f, -0.0015f * std::abs(nonLin));
+    float exponents[2] = { bend, nonLin > 0.0f ? bend : 1.0f };
+    for (auto half = 0; half < 2; half++) {
+        auto* table = c.shape + half * (kShapeTableSize + 2);
+        for (auto i = 0; i < kShapeTableSize + 2; i++) {
+            table[i] = std::pow((float)i / (float)kShapeTableSize, 2.0f * exponents[half]);
+        }
+    }
+
+    c.clip = juce::Decibels::decibelsToGain(plain(kHeadroom));
+    c.gain = juce::Decibels::decibelsToGain(plain(kOutput));
+
+    // the original's one pole coefficient, for each of the eight poles
+    auto r = 0.999f;
+    auto j = r * r - 1.0f;
+    auto k = 2.0f - 2.0f * r * r * std::cos(0.647f * postFilterToHz(plain(kPostFilter)) / fs);
+    c.filter = (std::sqrt(k * k - 4.0f * j * j) - k) / (2.0f * j);
+    c.filterGain = std::pow(1.0f - c.filter, 4.0f);
+}
+
+// audio thread: start ramping towards a new snapshot, over the usual
+// smoothing time unless rampSamples is given
+void MdaDegradeAudioProcessor::applyCoefficients(const Coefficients& c, int rampSamples) {
+    if (rampSamples < 0) {
+        gainSmoother.setTargetValue(c.gain);
+    } else {
+        gainSmoother.setTargetValue(c.gain, rampSamples);
+    }
+    divisor = c.divisor;
+    averaging = c.averaging;
+    quantise = c.quantise;
+    step = c.step;
+    linear = c.linear;
+    std::copy(std::begin(c.shape), std::end(c.shape), shape);
+    clip = c.clip;
+    filter = c.filter;
+    filterGain = c.filterGain;
+}
+
+// sample & hold or sample & average, a run of held samples at a time: each
+// run is summed and filled in one go, and only its last sample takes the new
+// value, which the next run then holds
+void MdaDegradeAudioProcessor::holdRuns (int numSamples) noexcept
+{
+    auto& st = state;
+    auto scale = 1.0f / (float)divisor;
+
+    for (auto pos = 0; pos < numSamples;)
+    {
+        auto run = juce::jmin(st.remaining, numSamples - pos);
+        auto* x = work + pos;
+        if (averaging) {
+            for (auto j = 0; j < run; j++) {
+                st.sum += x[j];
+            }
+        }
+        auto last = x[run - 1];
+        juce::FloatVectorOperations::fill(x, st.held, run);
+        pos += run;
+        st.remaining -= run;
+
+        if (st.remaining == 0) {
+            st.held = averaging ? st.sum * scale : last;
+            x[run - 1] = st.held;
+            st.sum = 0.0f;
+            st.remaining = divisor;
+        }
+    }
+}
+
+// every sample of the sub-block goes through the same steps, held or not, so
+// they run as straight vector loops
+void MdaDegradeAudioProcessor::quantiseAndShape (int numSamples) noexcept
+{
+    // truncated towards zero like the original, from a range an int holds
+    juce::FloatVectorOperations::clip(work, work, -2.0f, 2.0f, numSamples);
+    for (auto j = 0; j < numSamples; j++) {
+        work[j] = (float)(int)(work[j] * quantise) * step;
+    }
+
+    if (! linear) {
+        for (auto j = 0; j < numSamples; j++) {
+            auto x = work[j];
+            auto u = std::sqrt(juce::jmin(std::abs(x), 1.0f)) * (float)kShapeTableSize;
+            auto i = (int)u;
+            auto* table = shape + (x < 0.0f ? kShapeTableSize + 2 : 0);
+            auto y = table[i] + (u - (float)i) * (table[i + 1] - table[i]);
+            work[j] = x < 0.0f ? -y : y;
+        }
+    }
+
+    juce::FloatVectorOperations::clip(work, work, -clip, clip, numSamples); //headroom
+}
+
+// the pipeline, a sub-block at a time: mono sum, hold, quantise & shape,
+// output gain, then the post filter's eight poles
+template <typename SampleType, mda::ChannelLayout layout, bool hq>
+void MdaDegradeAudioProcessor::processChannels (juce::AudioBuffer<SampleType>& buffer, int numSamples)
+{
+    constexpr bool stereoIn = layout == mda::ChannelLayout::stereo;
+    constexpr bool stereoOut = layout != mda::ChannelLayout::mono;
+
+    auto* in1 = buffer.getReadPointer(0);
+    auto* in2 = stereoIn ? buffer.getReadPointer(1) : in1;
+    auto* out1 = buffer.getWritePointer(0);
+    auto* out2 = stereoOut ? buffer.getWritePointer(1) : nullptr;
+
+    auto f = filter, fg = filterGain;
+    float lp[8];
+    std::copy(std::begin(state.lp), std::end(state.lp), lp);
+
+    // the rate may just have gone up
+    state.remaining = juce::jmin(state.remaining, divisor);
+
+    for (auto start = 0; start < numSamples; start += kSubBlockSize)
+    {
+        auto todo = juce::jmin(kSubBlockSize, numSamples - start);
+        gainSmoother.render(gainRamp, todo);
+
+        for (auto j = 0; j < todo; j++) {
+            work[j] = (float)(in1[start + j] + in2[start + j]); //mono
+        }
+
+        if (divisor > 1) {
+            holdRuns(todo);
+        }
+        quantiseAndShape(todo);
+        juce::FloatVectorOperations::multiply(work, gainRamp, todo);
+
+        for (auto j = 0; j < todo; j++)
+        {
+            auto i = start + j;
+            lp[0] = fg * work[j] + f * lp[0]; //post filter
+            lp[1] = lp[0] + f * lp[1];
+            lp[2] = lp[1] + f * lp[2];
+            lp[3] = lp[2] + f * lp[3];
+            lp[4] = fg * lp[3] + f * lp[4];
+            lp[5] = lp[4] + f * lp[5];
+            lp[6] = lp[5] + f * lp[6];
+            lp[7] = lp[6] + f * lp[7];
+
+            auto c = lp[7];
+#ifdef DEBUG
+            mda::checkSample(c);
+#endif
+            out1[i] = (SampleType)c;
+            if constexpr (stereoOut) {
+                out2[i] = (SampleType)c;
+            }
+        }
+    }
+
+    //anti-denormal
+    for (auto& v : lp) {
+        if (std::abs(v) < 1.0e-10f) v = 0.0f;
+    }
+    std::copy(std::begin(lp), std::end(lp), state.lp);
+}
+
+//==============================================================================
+juce::AudioProcessorEditor* MdaDegradeAudioProcessor::createEditor()
+{
+    return new MdaDegradeAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+// (left out when the processors are built into a host such as mdaBenchmark)
+#if ! MDA_EMBEDDED_PLUGINS
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new MdaDegradeAudioProcessor();
+}
+#endif
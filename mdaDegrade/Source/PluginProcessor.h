@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// compile-time description of the plugin, see mda::Processor
+struct MdaDegradeDescription
+{
+    static constexpr const char* name = "mdaDegrade";
+    static constexpr const char* stateTag = "mdDg"; // identifies our binary state
+
+    // parameter indices, in the order of the table below
+    enum ParameterIndex
+    {
+        kHeadroom, kQuantise, kRate, kPostFilter, kNonLinearity, kOutput,
+        kNumParameters
+    };
+
+    static constexpr int kShapeTableSize = 256;
+
+    // the original's divisor of the host rate, negative for sample & hold and
+    // positive for sample & average
+    static int rateToDivisor(float percent)
+    {
+        return (int)std::exp(0.09f * std::abs(percent));
+    }
+
+    static juce::String rateToText(float value, int)
+    {
+        auto divisor = rateToDivisor(value);
+        if (divisor == 1)
+            return "Off";
+        return "1/" + juce::String(divisor) + (value > 0.0f ? " avg" : " hold");
+    }
+
+    static float postFilterToHz(float percent)
+    {
+        return std::pow(10.0f, 2.30104f + 0.02f * percent);
+    }
+
+    static juce::String postFilterToText(float value, int)
+    {
+        return juce::String(juce::roundToInt(postFilterToHz(value))) + " Hz";
+    }
+
+    // bending both halves of the wave gives odd harmonics, one half even ones
+    static juce::String nonLinearityToText(float value, int)
+    {
+        if (juce::roundToInt(value) == 0)
+            return "Off";
+        return juce::String(juce::roundToInt(std::abs(value))) + (value > 0.0f ? "% odd" : "% even");
+    }
+
+    static constexpr mda::ParameterSpec parameters[] =
+    {
+        //  id              name          min      max     step   default  label
+        // peak clipper
+        { "headroom",       "Headroom",   -30.0f,    0.0f,  0.1f,  -6.0f,   "dB" },
+        { "quantise",       "Quantise",     4.0f,   16.0f,  1.0f,  10.0f,   "bits" },
+        { "rate",           "Rate",      -100.0f,  100.0f,  1.0f,  30.0f,   "", rateToText },
+        { "postFilter",     "Post Filt",    0.0f,  100.0f,  1.0f,  90.0f,   "", postFilterToText },
+        { "nonLinearity",   "Non-Lin",   -100.0f,  100.0f,  1.0f,  16.0f,   "", nonLinearityToText },
+        { "output",         "Output",     -20.0f,   20.0f,  0.1f,   0.0f,   "dB" },
+    };
+
+    // the first program is the original mda one, the others were added for this port
+    static constexpr mda::Program<kNumParameters> programs[] =
+    {
+        //  name                      headrm quant  rate   post   nonlin output
+        { "Degrade",                { 0.80f, 0.50f, 0.65f, 0.90f, 0.58f, 0.50f } },
+        { "8-Bit Sampler",          { 1.00f, 0.33f, 0.40f, 0.75f, 0.50f, 0.50f } },
+        { "Telephone Grit",         { 0.60f, 0.42f, 0.68f, 0.40f, 0.30f, 0.60f } },
+        { "Crushed Drums",          { 0.70f, 0.17f, 0.30f, 1.00f, 0.75f, 0.45f } },
+    };
+
+    // everything update() derives from the parameters, as one immutable snapshot
+    struct Coefficients
+    {
+        int divisor; // of the host rate
+        bool averaging; // rather than sample & hold
+        float quantise, step; // into integer steps and back
+        bool linear; // no shaping, just the clipper
+        float shape[2 * (kShapeTableSize + 2)]; // each half of the wave, against the square root of the level
+        float clip, filter, filterGain, gain;
+    };
+};
+
+//==============================================================================
+/**
+*/
+class MdaDegradeAudioProcessor  : public mda::Processor<MdaDegradeAudioProcessor, MdaDegradeDescription>
+                            #if JucePlugin_Enable_ARA
+                             , public juce::AudioProcessorARAExtension
+                            #endif
+{
+public:
+    //==============================================================================
+    MdaDegradeAudioProcessor();
+    ~MdaDegradeAudioProcessor() override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+
+    void reset() override;
+
+private:
+    friend class mda::Processor<MdaDegradeAudioProcessor, MdaDegradeDescription>;
+
+    mda::RampedValue gainSmoother;
+    float gainRamp[kSubBlockSize];
+    alignas(16) float work[kSubBlockSize]; // each stage of the pipeline in turn, in place
+
+    int divisor = 1;
+    bool averaging = false, linear = true;
+    float quantise = 1.0f, step = 1.0f, clip = 1.0f, filter = 0.0f, filterGain = 1.0f;
+    float shape[2 * (kShapeTableSize + 2)] = {};
+
+    // everything the sample loop carries from one block to the next
+    struct State
+    {
+        int remaining = 1; // samples until the next one is taken, counting that one
+        float sum = 0.0f, held = 0.0f;
+        float lp[8] = {}; // post filter
+    };
+    State state;
+
+    // mda::Processor hooks
+    void prepareSmoothing(double sampleRate);
+    void saveDspState(mda::DspStateWriter& writer) const;
+    bool loadDspState(mda::DspStateReader& reader);
+    void update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const;
+    void applyCoefficients(const Coefficients& c, int rampSamples);
+
+    void holdRuns(int numSamples) noexcept;
+    void quantiseAndShape(int numSamples) noexcept;
+
+    template <typename SampleType, mda::ChannelLayout layout, bool hq>
+    void processChannels(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaDegradeAudioProcessor)
+};
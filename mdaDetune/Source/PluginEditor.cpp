@@ -0,0 +1,16 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaDetuneAudioProcessorEditor::MdaDetuneAudioProcessorEditor (MdaDetuneAudioProcessor& p)
+    : ProcessorEditor (p)
+{
+}
@@ -0,0 +1,25 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    The generic layout: one row per parameter and the level meters.
+*/
+class MdaDetuneAudioProcessorEditor  : public mda::ProcessorEditor<MdaDetuneAudioProcessor>
+{
+public:
+    explicit MdaDetuneAudioProcessorEditor (MdaDetuneAudioProcessor&);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaDetuneAudioProcessorEditor)
+};
@@ -0,0 +1,227 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaDetuneAudioProcessor::MdaDetuneAudioProcessor()
+{
+    reset();
+}
+
+MdaDetuneAudioProcessor::~MdaDetuneAudioProcessor()
+{
+}
+
+//==============================================================================
+void MdaDetuneAudioProcessor::prepareResources (double, int)
+{
+    buffers.allocate(3 * (size_t)kMaxBuffer + 1);
+    lines[0] = buffers.get();
+    lines[1] = lines[0] + kMaxBuffer;
+    window = lines[1] + kMaxBuffer;
+
+    auto dp = juce::MathConstants<double>::twoPi / kMaxBuffer;
+    for (auto i = 0; i <= kMaxBuffer; i++) { // one more for a delay rounded up to the length
+        window[i] = (float)(0.5 - 0.5 * std::cos(dp * i)); //hanning
+    }
+}
+
+void MdaDetuneAudioProcessor::prepareSmoothing (double sampleRate)
+{
+    drySmoother.reset(sampleRate, kSmoothingTime);
+    wetSmoother.reset(sampleRate, kSmoothingTime);
+}
+
+// the taps of a channel start half a buffer apart, so their windows sum to one
+void MdaDetuneAudioProcessor::reset()
+{
+    if (window != nullptr) {
+        juce::FloatVectorOperations::clear(lines[0], 2 * kMaxBuffer); // not the window
+    }
+    state = {};
+    for (auto lane = 0; lane < kNumLanes; lane++) {
+        state.delay[lane] = (lane & 1) ? 0.5f * (float)bufferLength : 0.0f;
+    }
+}
+
+// the live state for the optional snapshot in the saved state, in a fixed order
+void MdaDetuneAudioProcessor::saveDspState (mda::DspStateWriter& writer) const
+{
+    writer.writeSamples(lines[0], 2 * (size_t)kMaxBuffer);
+    writer.write(state.writePos);
+    writer.write(bufferLength);
+    for (auto d : state.delay) {
+        writer.write(d);
+    }
+}
+
+bool MdaDetuneAudioProcessor::loadDspState (mda::DspStateReader& reader)
+{
+    State st;
+    int length = 0;
+    auto ok = reader.readSamples(lines[0], 2 * (size_t)kMaxBuffer)
+           && reader.read(st.writePos) && reader.read(length)
+           && st.writePos >= 0 && st.writePos < kMaxBuffer && length > 0;
+    for (auto& d : st.delay) {
+        ok = ok && reader.read(d);
+    }
+
+    if (! ok)
+        return false;
+
+    // the delays are kept in proportion if the latency was changed since
+    for (auto& d : st.delay) {
+        d = juce::jlimit(0.0f, (float)bufferLength - 1.0f, d * (float)bufferLength / (float)length);
+    }
+    state = st;
+    return true;
+}
+
+// recalculate the coefficients depending on the changed parameters,
+// called off the audio thread
+void MdaDetuneAudioProcessor::update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const {
+    auto cents = detuneToCents(parameters[kDetune].convertFrom0to1(values[kDetune]));
+    c.up = std::exp2(cents / 1200.0f);
+    c.down = 1.0f / c.up;
+
+    auto mix = values[kMix];
+    auto gain = juce::Decibels::decibelsToGain(parameters[kOutput].convertFrom0to1(values[kOutput]));
+    c.dry = gain - gain * mix * mix;
+    c.wet = (gain + gain - gain * mix) * mix;
+
+    c.bufferLength = 1 << (kMinBufferBits + juce::roundToInt(parameters[kLatency].convertFrom0to1(values[kLatency])));
+}
+
+// audio thread: start ramping towards a new snapshot, over the usual
+// smoothing time unless rampSamples is given
+void MdaDetuneAudioProcessor::applyCoefficients(const Coefficients& c, int rampSamples) {
+    if (rampSamples < 0) {
+        drySmoother.setTargetValue(c.dry);
+        wetSmoother.setTargetValue(c.wet);
+    } else {
+        drySmoother.setTargetValue(c.dry, rampSamples);
+        wetSmoother.setTargetValue(c.wet, rampSamples);
+    }
+
+    // a tap's delay grows while it plays slower than the input
+    increment[0] = increment[1] = 1.0f - c.down;
+    increment[2] = increment[3] = 1.0f - c.up;
+
+    if (c.bufferLength != bufferLength) {
+        setBufferLength(c.bufferLength);
+    }
+}
+
+// scales the taps' delays to the new length, so the crossfades stay in step
+void MdaDetuneAudioProcessor::setBufferLength(int newLength) noexcept
+{
+    auto scale = (float)newLength / (float)bufferLength;
+    for (auto& d : state.delay) {
+        d = juce::jmin(d * scale, (float)newLength - 1.0f);
+    }
+    bufferLength = newLength;
+}
+
+// each channel is read by two taps sweeping its ring buffer half a buffer
+// apart, crossfaded by the window so one fades out as it wraps around; the
+// four taps run side by side as lanes, with only the reads done one by one
+template <typename SampleType, mda::ChannelLayout layout, bool hq>
+void MdaDetuneAudioProcessor::processChannels (juce::AudioBuffer<SampleType>& buffer, int numSamples)
+{
+    constexpr bool stereoIn = layout == mda::ChannelLayout::stereo;
+    constexpr bool stereoOut = layout != mda::ChannelLayout::mono;
+
+    auto* in1 = buffer.getReadPointer(0);
+    auto* in2 = stereoIn ? buffer.getReadPointer(1) : in1;
+    auto* out1 = buffer.getWritePointer(0);
+    auto* out2 = stereoOut ? buffer.getWritePointer(1) : nullptr;
+
+    auto* line1 = lines[0];
+    auto* line2 = stereoIn ? lines[1] : lines[0];
+    const float* laneLine[kNumLanes] = { line1, line1, line2, line2 };
+
+    auto st = state;
+    auto len = (float)bufferLength;
+    auto windowScale = (float)(kMaxBuffer / bufferLength); // window table stride
+    alignas(16) float s0[kNumLanes], s1[kNumLanes], frac[kNumLanes], gain[kNumLanes], y[kNumLanes];
+
+    for (auto start = 0; start < numSamples; start += kSubBlockSize)
+    {
+        auto todo = juce::jmin(kSubBlockSize, numSamples - start);
+        drySmoother.render(dryRamp, todo);
+        wetSmoother.render(wetRamp, todo);
+
+        for (auto j = 0; j < todo; j++)
+        {
+            auto i = start + j;
+            auto a = (float)in1[i];
+            auto b = (float)in2[i];
+            line1[st.writePos] = a;
+            if constexpr (stereoIn) {
+                line2[st.writePos] = b;
+            }
+
+            // wrapped with selects rather than branches
+            for (auto lane = 0; lane < kNumLanes; lane++) {
+                auto d = st.delay[lane] + increment[lane];
+                d += d < 0.0f ? len : 0.0f;
+                d -= d >= len ? len : 0.0f;
+                st.delay[lane] = d;
+            }
+
+            auto base = (float)(st.writePos + kMaxBuffer);
+            for (auto lane = 0; lane < kNumLanes; lane++) {
+                auto pos = base - st.delay[lane];
+                auto p = (int)pos;
+                frac[lane] = pos - (float)p;
+                s0[lane] = laneLine[lane][p & kMask];
+                s1[lane] = laneLine[lane][(p + 1) & kMask];
+                gain[lane] = window[(int)(st.delay[lane] * windowScale)];
+            }
+
+            for (auto lane = 0; lane < kNumLanes; lane++) {
+                y[lane] = gain[lane] * (s0[lane] + frac[lane] * (s1[lane] - s0[lane])); //linear interpolation
+            }
+
+            st.writePos = (st.writePos + 1) & kMask;
+
+            auto c = dryRamp[j] * a + wetRamp[j] * (y[0] + y[1]);
+            auto d = dryRamp[j] * b + wetRamp[j] * (y[2] + y[3]);
+#ifdef DEBUG
+            mda::checkSample(c);
+            mda::checkSample(d);
+#endif
+            if constexpr (stereoOut) {
+                out1[i] = (SampleType)c;
+                out2[i] = (SampleType)d;
+            } else {
+                out1[i] = (SampleType)(0.5f * (c + d));
+            }
+        }
+    }
+
+    state = st;
+}
+
+//==============================================================================
+juce::AudioProcessorEditor* MdaDetuneAudioProcessor::createEditor()
+{
+    return new MdaDetuneAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+// (left out when the processors are built into a host such as mdaBenchmark)
+#if ! MDA_EMBEDDED_PLUGINS
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new MdaDetuneAudioProcessor();
+}
+#endif
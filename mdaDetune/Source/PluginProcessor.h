@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// compile-time description of the plugin, see mda::Processor
+struct MdaDetuneDescription
+{
+    static constexpr const char* name = "mdaDetune";
+    static constexpr const char* stateTag = "mdDt"; // identifies our binary state
+
+    // parameter indices, in the order of the table below
+    enum ParameterIndex
+    {
+        kDetune, kMix, kOutput, kLatency,
+        kNumParameters
+    };
+
+    // cubic, for fine control of the small amounts: up to 3 semitones
+    static float detuneToCents(float percent)
+    {
+        auto p = 0.01f * percent;
+        return 300.0f * p * p * p;
+    }
+
+    static juce::String detuneToText(float value, int)
+    {
+        return juce::String(detuneToCents(value), 1);
+    }
+
+    // the delay buffer the taps sweep across, 256 to 4096 samples
+    static constexpr int kMinBufferBits = 8;
+    static constexpr int kMaxBuffer = 1 << (kMinBufferBits + 4);
+
+    static juce::String latencyToText(float value, int)
+    {
+        return juce::String(1 << (kMinBufferBits + juce::roundToInt(value)));
+    }
+
+    static constexpr mda::ParameterSpec parameters[] =
+    {
+        //  id          name         min      max     step   default  label
+        { "detune",     "Detune",    0.0f,  100.0f,  0.1f,  20.0f,   "cents", detuneToText },
+        { "mix",        "Mix",       0.0f,  100.0f,  1.0f,  90.0f,   "%" },
+        { "output",     "Output",  -20.0f,   20.0f,  0.1f,   0.0f,   "dB" },
+        { "latency",    "Latency",   0.0f,    4.0f,  1.0f,   2.0f,   "samples", latencyToText },
+    };
+
+    // the first program is the original mda one, the others were added for this port
+    static constexpr mda::Program<kNumParameters> programs[] =
+    {
+        //  name                      detune mix    output latency
+        { "Stereo Detune",          { 0.20f, 0.90f, 0.50f, 0.50f } },
+        { "Symphonic",              { 0.30f, 0.90f, 0.50f, 0.50f } },
+        { "Out Of Tune",            { 0.60f, 0.90f, 0.50f, 0.50f } },
+        { "Vocal Doubler",          { 0.25f, 0.70f, 0.50f, 1.00f } },
+        { "Tight Width",            { 0.15f, 0.60f, 0.50f, 0.25f } },
+    };
+
+    // everything update() derives from the parameters, as one immutable snapshot
+    struct Coefficients
+    {
+        float down, up; // pitch ratios of the left & right channels
+        float dry, wet;
+        int bufferLength; // samples the taps sweep over
+    };
+};
+
+//==============================================================================
+/**
+*/
+class MdaDetuneAudioProcessor  : public mda::Processor<MdaDetuneAudioProcessor, MdaDetuneDescription>
+                            #if JucePlugin_Enable_ARA
+                             , public juce::AudioProcessorARAExtension
+                            #endif
+{
+public:
+    //==============================================================================
+    MdaDetuneAudioProcessor();
+    ~MdaDetuneAudioProcessor() override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+
+    void reset() override;
+
+private:
+    friend class mda::Processor<MdaDetuneAudioProcessor, MdaDetuneDescription>;
+
+    // four taps, two per channel half a buffer apart: left down, right up
+    static constexpr int kNumLanes = 4;
+
+    // one ring per channel at the longest latency, and a hanning window of the
+    // same length that shorter buffers read with a stride
+    mda::DspBuffer<float> buffers;
+    float* lines[2] = { nullptr, nullptr };
+    float* window = nullptr;
+    static constexpr int kMask = kMaxBuffer - 1;
+
+    mda::RampedValue drySmoother, wetSmoother;
+    float dryRamp[kSubBlockSize], wetRamp[kSubBlockSize];
+    alignas(16) float increment[kNumLanes] = {}; // delay change per sample, 1 - ratio
+    int bufferLength = 1024;
+
+    // everything the sample loop carries from one block to the next
+    struct State
+    {
+        int writePos = 0;
+        alignas(16) float delay[kNumLanes] = {}; // of each tap, 0 to bufferLength
+    };
+    State state;
+
+    // mda::Processor hooks
+    void prepareResources(double sampleRate, int maximumBlockSize);
+    void prepareSmoothing(double sampleRate);
+    size_t dspHeapBytes() const noexcept { return buffers.getHeapBytes(); }
+    void saveDspState(mda::DspStateWriter& writer) const;
+    bool loadDspState(mda::DspStateReader& reader);
+    void update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const;
+    void applyCoefficients(const Coefficients& c, int rampSamples);
+
+    void setBufferLength(int newLength) noexcept;
+
+    template <typename SampleType, mda::ChannelLayout layout, bool hq>
+    void processChannels(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaDetuneAudioProcessor)
+};
@@ -14,12 +14,13 @@ enum
     paramControlHeight = 40,
     paramLabelWidth    = 120,
     paramSliderWidth   = 300,
-    uiRows = 8 // for calculating label spacing of parameters + comment/copyright label
+    uiRows = 16 // for calculating label spacing of parameters + comment/copyright label
 };
 
 //==============================================================================
 MdaDubDelayAudioProcessorEditor::MdaDubDelayAudioProcessorEditor (MdaDubDelayAudioProcessor& p, juce::AudioProcessorValueTreeState& vts)
-    : AudioProcessorEditor (&p), audioProcessor (p), apvts (vts)
+    : AudioProcessorEditor (&p), audioProcessor (p), apvts (vts),
+      delayTimeMeter (mda::BarMeter::Scale::linear, 0.0f, vts.getParameterRange("delay").end)
 {
     delayLabel.setText("Delay", juce::dontSendNotification);
     addAndMakeVisible(delayLabel);
@@ -56,11 +57,74 @@ MdaDubDelayAudioProcessorEditor::MdaDubDelayAudioProcessorEditor (MdaDubDelayAud
     addAndMakeVisible(outputSlider);
     outputAttachment.reset(new juce::AudioProcessorValueTreeState::SliderAttachment (apvts, "output", outputSlider));
     
+    tapsLabel.setText("Taps", juce::dontSendNotification);
+    addAndMakeVisible(tapsLabel);
+    addAndMakeVisible(tapsSlider);
+    tapsAttachment.reset(new juce::AudioProcessorValueTreeState::SliderAttachment (apvts, "taps", tapsSlider));
+
+    const char* tapFieldNames[] = { "Tap Time", "Tap Gain", "Tap Pan" };
+    for (int field = 0; field < 3; ++field) {
+        tapFieldLabels[field].setText(tapFieldNames[field], juce::dontSendNotification);
+        addAndMakeVisible(tapFieldLabels[field]);
+
+        for (int tap = 0; tap < MdaDubDelayDescription::kMaxTaps; ++tap) {
+            auto& slider = tapSliders[field][tap];
+            slider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+            slider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+            slider.setPopupDisplayEnabled(true, true, this);
+            addAndMakeVisible(slider);
+
+            auto index = MdaDubDelayDescription::tapParameter(tap, (MdaDubDelayDescription::TapField)field);
+            tapAttachments[field][tap].reset(new juce::AudioProcessorValueTreeState::SliderAttachment (apvts, MdaDubDelayDescription::parameters[index].id, slider));
+        }
+    }
+
+    inputMeterLabel.setText("Input", juce::dontSendNotification);
+    addAndMakeVisible(inputMeterLabel);
+    addAndMakeVisible(inputMeterL);
+    addAndMakeVisible(inputMeterR);
+
+    outputMeterLabel.setText("Output", juce::dontSendNotification);
+    addAndMakeVisible(outputMeterLabel);
+    addAndMakeVisible(outputMeterL);
+    addAndMakeVisible(outputMeterR);
+
+    delayTimeLabel.setText("Delay Time", juce::dontSendNotification);
+    addAndMakeVisible(delayTimeLabel);
+    addAndMakeVisible(delayTimeMeter);
+
+    limiterLabel.setText("Limiter", juce::dontSendNotification);
+    addAndMakeVisible(limiterLabel);
+    addAndMakeVisible(limiterMeter);
+
+    dspStateButton.setToggleState(audioProcessor.getSavesDspState(), juce::dontSendNotification);
+    dspStateButton.onClick = [this] { audioProcessor.setSavesDspState(dspStateButton.getToggleState()); };
+    addAndMakeVisible(dspStateButton);
+
+    audioProcessor.meters.addConsumer();
+    
     setSize (paramSliderWidth + paramLabelWidth, juce::jmax (100, paramControlHeight * uiRows));
 }
 
 MdaDubDelayAudioProcessorEditor::~MdaDubDelayAudioProcessorEditor()
 {
+    audioProcessor.meters.removeConsumer();
+}
+
+// called on every display refresh, only repaints the meters that moved
+void MdaDubDelayAudioProcessorEditor::updateMeters()
+{
+    if (! audioProcessor.meters.pull(meterFrame))
+        return;
+
+    inputMeterL.setValue(meterFrame.inputPeak[0]);
+    inputMeterR.setValue(meterFrame.inputPeak[1]);
+    outputMeterL.setValue(meterFrame.outputPeak[0]);
+    outputMeterR.setValue(meterFrame.outputPeak[1]);
+
+    auto sampleRate = audioProcessor.getSampleRate();
+    delayTimeMeter.setValue(sampleRate > 0.0 ? (float)(meterFrame.values[0] / sampleRate) : 0.0f);
+    limiterMeter.setValue(meterFrame.values[1]);
 }
 
 //==============================================================================
@@ -81,6 +145,9 @@ void MdaDubDelayAudioProcessorEditor::resized()
     auto r = getLocalBounds();
     auto sliderHeight = r.getHeight() / uiRows;
 
+    // shares the bottom row with the credits
+    dspStateButton.setBounds(r.removeFromBottom(sliderHeight).removeFromLeft(paramLabelWidth));
+
     auto labelRect = juce::Rectangle<int>(0, 0, paramLabelWidth, sliderHeight);
     auto sliderRect = juce::Rectangle<int>(paramLabelWidth, 0, paramSliderWidth, sliderHeight);
 
@@ -117,5 +184,47 @@ void MdaDubDelayAudioProcessorEditor::resized()
     outputLabel.setBounds(labelRect);
     outputSlider.setBounds(sliderRect);
     
-    
+    labelRect.translate(0, sliderHeight);
+    sliderRect.translate(0, sliderHeight);
+    tapsLabel.setBounds(labelRect);
+    tapsSlider.setBounds(sliderRect);
+
+    for (auto field = 0; field < 3; ++field) {
+        labelRect.translate(0, sliderHeight);
+        sliderRect.translate(0, sliderHeight);
+        tapFieldLabels[field].setBounds(labelRect);
+
+        auto knobRect = sliderRect;
+        auto knobWidth = sliderRect.getWidth() / MdaDubDelayDescription::kMaxTaps;
+        for (auto& slider : tapSliders[field]) {
+            slider.setBounds(knobRect.removeFromLeft(knobWidth));
+        }
+    }
+
+    // meter rows, stereo meters are split into two bars
+    auto meterRect = sliderRect.reduced(4, sliderHeight / 4);
+
+    labelRect.translate(0, sliderHeight);
+    meterRect.translate(0, sliderHeight);
+    inputMeterLabel.setBounds(labelRect);
+    auto stereoRect = meterRect;
+    inputMeterL.setBounds(stereoRect.removeFromTop(meterRect.getHeight() / 2 - 1));
+    inputMeterR.setBounds(stereoRect.removeFromBottom(meterRect.getHeight() / 2 - 1));
+
+    labelRect.translate(0, sliderHeight);
+    meterRect.translate(0, sliderHeight);
+    outputMeterLabel.setBounds(labelRect);
+    stereoRect = meterRect;
+    outputMeterL.setBounds(stereoRect.removeFromTop(meterRect.getHeight() / 2 - 1));
+    outputMeterR.setBounds(stereoRect.removeFromBottom(meterRect.getHeight() / 2 - 1));
+
+    labelRect.translate(0, sliderHeight);
+    meterRect.translate(0, sliderHeight);
+    delayTimeLabel.setBounds(labelRect);
+    delayTimeMeter.setBounds(meterRect);
+
+    labelRect.translate(0, sliderHeight);
+    meterRect.translate(0, sliderHeight);
+    limiterLabel.setBounds(labelRect);
+    limiterMeter.setBounds(meterRect);
 }
@@ -59,5 +59,36 @@ private:
     juce::Slider outputSlider;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> outputAttachment;
     
+    juce::Label tapsLabel;
+    juce::Slider tapsSlider;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> tapsAttachment;
+
+    // one row of small knobs per tap field, one column per tap
+    juce::Label tapFieldLabels[3];
+    juce::Slider tapSliders[3][MdaDubDelayDescription::kMaxTaps];
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> tapAttachments[3][MdaDubDelayDescription::kMaxTaps];
+
+    // live meters, fed from the processor's MeterSource on every display refresh
+    juce::Label inputMeterLabel;
+    mda::BarMeter inputMeterL { mda::BarMeter::Scale::decibels, -60.0f, 6.0f };
+    mda::BarMeter inputMeterR { mda::BarMeter::Scale::decibels, -60.0f, 6.0f };
+
+    juce::Label outputMeterLabel;
+    mda::BarMeter outputMeterL { mda::BarMeter::Scale::decibels, -60.0f, 6.0f };
+    mda::BarMeter outputMeterR { mda::BarMeter::Scale::decibels, -60.0f, 6.0f };
+
+    juce::Label delayTimeLabel;
+    mda::BarMeter delayTimeMeter;
+
+    juce::Label limiterLabel;
+    mda::BarMeter limiterMeter { mda::BarMeter::Scale::decibels, -24.0f, 6.0f };
+
+    // opt-in snapshot of the delay lines & filter states in the saved state
+    juce::ToggleButton dspStateButton { "Save DSP state" };
+
+    mda::MeterFrame meterFrame;
+    void updateMeters();
+    juce::VBlankAttachment vBlankAttachment { this, [this] { updateMeters(); } };
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaDubDelayAudioProcessorEditor)
 };
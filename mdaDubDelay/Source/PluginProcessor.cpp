@@ -9,428 +9,465 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
-constexpr float kMaxDelayTime = 16.0f; // in seconds
-
-namespace ParameterID
-{
-    #define PARAMETER_ID(str) const juce::ParameterID str(#str, 1);
-
-    PARAMETER_ID(delay)
-    PARAMETER_ID(feedback)
-    PARAMETER_ID(feedbackTone)
-    PARAMETER_ID(lfoDepth)
-    PARAMETER_ID(lfoRate)
-    PARAMETER_ID(wetMix)
-    PARAMETER_ID(output)
-
-    #undef PARAMETER_ID
-}
-
-#ifdef DEBUG
-inline void checkSample(float& x) {
-    if (std::isnan(x)) {
-        DBG("!!! WARNING: nan detected in audio buffer, silencing !!!");
-        x = 0.0f;
-    } else if (std::isinf(x)) {
-        DBG("!!! WARNING: inf detected in audio buffer, silencing !!!");
-        x = 0.0f;
-    } else if (x < -2.0f || x > 2.0f) {  // screaming feedback
-        DBG("!!! WARNING: sample out of range, silencing !!!");
-        x = 0.0f;
-    } else if (x < -1.0f) {
-        x = -1.0f;
-    } else if (x > 1.0f) {
-        x = 1.0f;
-    }
-}
-#endif
-
-// Returns a typed pointer to a juce::AudioParameterXXX object from the APVTS.
-template<typename T>
-inline static void castParameter(juce::AudioProcessorValueTreeState& apvts, const juce::ParameterID& id, T& destination)
-{
-    destination = dynamic_cast<T>(apvts.getParameter(id.getParamID()));
-    jassert(destination);
-}
-
 //==============================================================================
 MdaDubDelayAudioProcessor::MdaDubDelayAudioProcessor()
-#ifndef JucePlugin_PreferredChannelConfigurations
-     : AudioProcessor (BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                       )
-#endif
 {
-    castParameter(apvts, ParameterID::delay, delayParam);
-    castParameter(apvts, ParameterID::feedback, feedbackParam);
-    castParameter(apvts, ParameterID::feedbackTone, feedbackToneParam);
-    castParameter(apvts, ParameterID::lfoDepth, lfoDepthParam);
-    castParameter(apvts, ParameterID::lfoRate, lfoRateParam);
-    castParameter(apvts, ParameterID::wetMix, wetMixParam);
-    castParameter(apvts, ParameterID::output, outputParam);
-    apvts.state.addListener(this);
     reset();
 }
 
 MdaDubDelayAudioProcessor::~MdaDubDelayAudioProcessor()
 {
-    apvts.state.removeListener(this);
-    if (mybuffer) {
-        delete [] mybuffer;
-    }
-    mybuffer = nullptr;
-    allocatedBufferSize = 0;
 }
 
 //==============================================================================
-const juce::String MdaDubDelayAudioProcessor::getName() const
+void MdaDubDelayAudioProcessor::prepareResources (double sampleRate, int)
 {
-    return JucePlugin_Name;
-}
+    // allocated here rather than in the constructor, so scanning hosts don't pay for 16s of audio
+    allocatedBufferSize = (long) (kMaxDelayTime * sampleRate);
+    delayBuffer.allocate((size_t) allocatedBufferSize + 1);
 
-bool MdaDubDelayAudioProcessor::acceptsMidi() const
-{
-   #if JucePlugin_WantsMidiInput
-    return true;
-   #else
-    return false;
-   #endif
+    if (sampleRate != crossoverTableRate)
+    {
+        // the curve is steeper at lower rates: 2048 points from 44.1kHz up and
+        // proportionally more below keep it within MappingTable's error bound
+        auto fs = (float)sampleRate;
+        auto numPoints = juce::nextPowerOfTwo(juce::jmax(2048, (int)std::ceil(2048.0 * 44100.0 / sampleRate)));
+        crossoverTable.initialise([fs] (float x) {
+                                      return expf(-juce::MathConstants<float>::twoPi * std::powf(10.0f, 2.2f + 4.5f * x) / fs);
+                                  }, 0.0f, 0.5f, (size_t)numPoints);
+        crossoverTableRate = sampleRate;
+    }
 }
 
-bool MdaDubDelayAudioProcessor::producesMidi() const
+void MdaDubDelayAudioProcessor::prepareSmoothing (double sampleRate)
 {
-   #if JucePlugin_ProducesMidiOutput
-    return true;
-   #else
-    return false;
-   #endif
+    for (auto* smoother : { &wetSmoother, &drySmoother, &feedbackSmoother,
+                            &filterSmoother, &lowMixSmoother, &highMixSmoother }) {
+        smoother->reset(sampleRate, kSmoothingTime);
+    }
+    tapGlide = 1.0f - (float)std::exp(-kSubBlockSize / (kSmoothingTime * sampleRate));
 }
 
-bool MdaDubDelayAudioProcessor::isMidiEffect() const
-{
-   #if JucePlugin_IsMidiEffect
-    return true;
-   #else
-    return false;
-   #endif
+void MdaDubDelayAudioProcessor::reset() {
+    delayBuffer.clear();
+    state = {};
+    tapNow = tapTarget;
+    tapsSounding = numTaps > 0;
 }
 
-double MdaDubDelayAudioProcessor::getTailLengthSeconds() const
+size_t MdaDubDelayAudioProcessor::dspHeapBytes() const noexcept
 {
-    return 0.0;
+    return delayBuffer.getHeapBytes() + crossoverTable.getHeapBytes();
 }
 
-int MdaDubDelayAudioProcessor::getNumPrograms()
+// the live state for the optional snapshot in the saved state, in a fixed order
+void MdaDubDelayAudioProcessor::saveDspState (mda::DspStateWriter& writer) const
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
-}
+    for (auto value : { state.fil0, state.env, state.xPrev[0], state.xPrev[1] }) {
+        writer.write(value);
+    }
+    for (auto value : { state.dlbuf, state.dlTarget, state.dlStep, state.phi }) {
+        writer.write(value);
+    }
+    writer.write(state.ipos);
+    writer.write(state.lfoCountdown);
 
-int MdaDubDelayAudioProcessor::getCurrentProgram()
-{
-    return 0;
-}
+    for (auto* taps : { tapNow.ratio, tapNow.left, tapNow.right }) {
+        for (int t = 0; t < kMaxTaps; ++t) {
+            writer.write(taps[t]);
+        }
+    }
+    writer.write(tapsSounding);
 
-void MdaDubDelayAudioProcessor::setCurrentProgram (int index)
-{
+    writer.writeSamples(delayBuffer.get(), delayBuffer.getSize());
 }
 
-const juce::String MdaDubDelayAudioProcessor::getProgramName (int index)
+bool MdaDubDelayAudioProcessor::loadDspState (mda::DspStateReader& reader)
 {
-    return {};
-}
+    State st;
+    auto ok = reader.read(st.fil0) && reader.read(st.env) && reader.read(st.xPrev[0]) && reader.read(st.xPrev[1])
+           && reader.read(st.dlbuf) && reader.read(st.dlTarget) && reader.read(st.dlStep) && reader.read(st.phi)
+           && reader.read(st.ipos) && reader.read(st.lfoCountdown);
+
+    Taps taps;
+    for (auto* values : { taps.ratio, taps.left, taps.right }) {
+        for (int t = 0; t < kMaxTaps; ++t) {
+            ok = ok && reader.read(values[t]);
+        }
+    }
+    bool sounding = false;
+    ok = ok && reader.read(sounding)
+            && st.ipos >= 0 && st.ipos <= allocatedBufferSize
+            && reader.readSamples(delayBuffer.get(), delayBuffer.getSize());
 
-void MdaDubDelayAudioProcessor::changeProgramName (int index, const juce::String& newName)
-{
+    if (! ok)
+        return false;
+
+    state = st;
+    tapNow = taps;
+    tapsSounding = sounding;
+    return true;
 }
 
-//==============================================================================
-void MdaDubDelayAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+// recalculate the coefficients depending on the changed parameters,
+// called off the audio thread
+void MdaDubDelayAudioProcessor::update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const
 {
-    long newSize = (long) (kMaxDelayTime * sampleRate);
-    if (newSize != allocatedBufferSize)
+    // normalised values, as in the original mda code
+    if (changed & (dirtyBit(kDelay) | dirtyBit(kLfoDepth)))
+    {
+        auto delayValue = values[kDelay];
+        auto delaySize = (float)(long)(kMaxDelayTime * fs);
+        c.del = delayValue * delayValue * delaySize;
+        if (c.del > delaySize)
+            c.del = delaySize;
+        c.mod = 0.049f * values[kLfoDepth] * c.del;
+    }
+
+    if (changed & dirtyBit(kFeedbackTone))
     {
-        if (mybuffer != NULL) {
-            delete [] mybuffer;
+        c.fil = values[kFeedbackTone];
+        if (c.fil>0.5f)  //simultaneously change crossover frequency & high/low mix
+        {
+          c.fil = 0.5f * c.fil - 0.25f;
+          c.lmix = -2.0f * c.fil;
+          c.hmix = 1.0f;
+        }
+        else
+        {
+          c.hmix = 2.0f * c.fil;
+          c.lmix = 1.0f - c.hmix;
+        }
+        c.fil = crossoverTable(c.fil);
+    }
+
+    if (changed & dirtyBit(kFeedback))
+    {
+        auto feedbackValue = values[kFeedback];
+        c.fbk = std::fabs(2.2f * feedbackValue - 1.1f);
+        if (feedbackValue>0.5f) {
+            c.rel=0.9997f;
+        }
+        else
+        {
+            c.rel=0.8f; //limit or clip
+        }
+    }
+
+    if (changed & (dirtyBit(kWetMix) | dirtyBit(kOutput)))
+    {
+        auto wetMixValue = values[kWetMix];
+        auto outputValue = mda::outputLevelToGain(parameters[kOutput].convertFrom0to1(values[kOutput]));
+        c.wet = 1.0f - wetMixValue;
+        c.wet = outputValue * (1.0f - c.wet * c.wet); //-3dB at 50% mix
+        c.dry = outputValue * 2.0f * (1.0f - wetMixValue * wetMixValue);
+    }
+
+    if (changed & dirtyBit(kLfoRate))
+    {
+        static const mda::MappingTable lfoRateToHz { [] (float x) { return std::exp(7.0f * x - 4.0f); },
+                                                     0.0f, 1.0f, 512 };
+        float lfoHz = lfoRateToHz(values[kLfoRate]);
+        c.dphi = 628.31853f * lfoHz / fs; //100-sample steps
+    }
+
+    if (changed & ~(dirtyBit(kTaps) - 1)) // the tap count or any tap parameter
+    {
+        c.numTaps = juce::roundToInt(parameters[kTaps].convertFrom0to1(values[kTaps]));
+        for (int t = 0; t < kMaxTaps; ++t)
+        {
+            auto gain = t < c.numTaps ? values[tapParameter(t, kTapGain)] : 0.0f;
+            auto pan = values[tapParameter(t, kTapPan)] * juce::MathConstants<float>::halfPi; //equal power
+            c.tapRatio[t] = values[tapParameter(t, kTapTime)];
+            c.tapLeft[t] = gain * std::cos(pan);
+            c.tapRight[t] = gain * std::sin(pan);
         }
-        allocatedBufferSize = newSize;
-        mybuffer = new float[allocatedBufferSize];
     }
-    parametersChanged.store(true);
-    reset();
 }
 
-void MdaDubDelayAudioProcessor::reset() {
-    if (mybuffer != nullptr) {
-        memset(mybuffer, 0, allocatedBufferSize * sizeof(float));
+// audio thread: start ramping towards a new snapshot, over the usual
+// smoothing time unless rampSamples is given
+void MdaDubDelayAudioProcessor::applyCoefficients(const Coefficients& c, int rampSamples)
+{
+    del = c.del;
+    mod = c.mod;
+    rel = c.rel;
+    dphi = c.dphi;
+
+    numTaps = c.numTaps; // the taps glide in the kernel, whatever the ramp
+    std::copy(std::begin(c.tapRatio), std::end(c.tapRatio), tapTarget.ratio);
+    std::copy(std::begin(c.tapLeft), std::end(c.tapLeft), tapTarget.left);
+    std::copy(std::begin(c.tapRight), std::end(c.tapRight), tapTarget.right);
+
+    if (rampSamples < 0) {
+        filterSmoother.setTargetValue(c.fil);
+        lowMixSmoother.setTargetValue(c.lmix);
+        highMixSmoother.setTargetValue(c.hmix);
+        feedbackSmoother.setTargetValue(c.fbk);
+        wetSmoother.setTargetValue(c.wet);
+        drySmoother.setTargetValue(c.dry);
+    } else {
+        filterSmoother.setTargetValue(c.fil, rampSamples);
+        lowMixSmoother.setTargetValue(c.lmix, rampSamples);
+        highMixSmoother.setTargetValue(c.hmix, rampSamples);
+        feedbackSmoother.setTargetValue(c.fbk, rampSamples);
+        wetSmoother.setTargetValue(c.wet, rampSamples);
+        drySmoother.setTargetValue(c.dry, rampSamples);
     }
-    outputLevelSmoother.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(outputParam->get()));
 }
 
-void MdaDubDelayAudioProcessor::releaseResources()
+// the modulated delay time (samples) & limiter envelope for the editor
+void MdaDubDelayAudioProcessor::pushMeters (int numSamples)
 {
-    
+    meters.push(numSamples, state.dlbuf, (float)state.env);
 }
 
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool MdaDubDelayAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+// the delay, feedback filter & limiter are shared, so mono only saves the second output
+template <typename SampleType, mda::ChannelLayout layout, bool hq>
+void MdaDubDelayAudioProcessor::processChannels (juce::AudioBuffer<SampleType>& buffer, int numSamples)
 {
-  #if JucePlugin_IsMidiEffect
-    juce::ignoreUnused (layouts);
-    return true;
-  #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
+    constexpr bool stereoIn = layout == mda::ChannelLayout::stereo;
+    constexpr bool stereoOut = layout != mda::ChannelLayout::mono;
+
+    auto st = state;
+    SampleType a, b = 0, c, d = 0, ol, tmp;
+    float w, y, fb, dl=st.dlbuf, db=st.dlTarget, ddl=st.dlStep, rem, phi=st.phi;
+    float lx, hx, f;
+    SampleType f0=(SampleType)st.fil0;
+    SampleType e=(SampleType)st.env, g, r=rel; //limiter envelope, gain, release
+    SampleType xp=(SampleType)st.xPrev[0], xp2=(SampleType)st.xPrev[1]; //high quality: previous limiter inputs
+    long i=st.ipos, l, s=allocatedBufferSize, k=st.lfoCountdown; // carried over, so tiny blocks keep the 100-sample rate
+    auto* mybuffer = delayBuffer.get();
+
+    auto* in1 = buffer.getReadPointer (0);
+    auto* in2 = stereoIn ? buffer.getReadPointer (1) : nullptr;
+    auto* out1 = buffer.getWritePointer (0);
+    auto* out2 = stereoOut ? buffer.getWritePointer (1) : nullptr;
+    long tapBase[kSubBlockSize]; // write position & delay per sample, for the multi-tap pass
+    float tapDelay[kSubBlockSize];
+
+    for (auto start = 0; start < numSamples; start += kSubBlockSize)
+    {
+        auto todo = juce::jmin (kSubBlockSize, numSamples - start);
+        auto tapsActive = glideTaps();
+        wetSmoother.render (wetRamp, todo);
+        drySmoother.render (dryRamp, todo);
+        feedbackSmoother.render (feedbackRamp, todo);
+        if constexpr (hq) {
+            filterSmoother.render (filterRamp, todo);
+            lowMixSmoother.render (lowMixRamp, todo);
+            highMixSmoother.render (highMixRamp, todo);
+        } else {
+            f = filterSmoother.skip (todo);
+            lx = lowMixSmoother.skip (todo);
+            hx = highMixSmoother.skip (todo);
+        }
 
-    // This checks if the input layout matches the output layout
-   #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-   #endif
+        for (auto j = 0; j < todo; j++)
+        {
+            auto samp = start + j;
+            a = in1[samp];
+            c = a;
+            if constexpr (stereoIn) {
+                b = in2[samp];
+                d = b;
+            }
+            w = wetRamp[j];
+            y = dryRamp[j];
+            fb = feedbackRamp[j];
+            if constexpr (hq) {
+                f = filterRamp[j];
+                lx = lowMixRamp[j];
+                hx = highMixRamp[j];
+            }
+
+            if (k==0) //update delay length at slower rate (could be improved!)
+            {
+                db += 0.01f * (del - db - mod - mod * std::sinf(phi)); //smoothed delay+lfo
+                ddl = 0.01f * (db - dl); //linear step
+                phi+=dphi;
+                if (phi>juce::MathConstants<float>::twoPi) phi-=juce::MathConstants<float>::twoPi;
+                k=100;
+            }
+            k--;
+            dl += ddl; //lin interp between points
+
+            i--; if (i<0) i=s; //delay positions
+            tapBase[j] = i;
+            tapDelay[j] = dl;
+
+            l = (long)dl;
+            rem = dl - (float)l; //remainder
+            l += i; if (l>s) l-=(s+1);
+
+            if constexpr (hq) {
+                ol = readCubic(l, rem); //delay output, 4-point interp
+            } else {
+                ol = *(mybuffer + l); //delay output
+
+                l++; if (l>s) l=0;
+                ol += rem * (*(mybuffer + l) - ol); //lin interp
+            }
+
+            tmp = a + fb * ol;
+
+            f0 = f * (f0 - tmp) + tmp; //low-pass filter
+            tmp = lx * f0 + hx * tmp;
+
+            g = (tmp<0)? -tmp : tmp; //simple limiter
+            if constexpr (hq) {
+                // the detector also looks half way back to the previous sample, on
+                // the parabola through the last three, to catch peaks between
+                // samples; the audio path stays the same as in realtime
+                auto mid = (SampleType)0.125 * ((SampleType)6 * xp + (SampleType)3 * tmp - xp2);
+                g = juce::jmax(g, std::abs(mid));
+                xp2 = xp;
+                xp = tmp;
+            }
+            e *= r; if (g>e) e = g;
+            if (e>1) tmp /= e;
+
+            *(mybuffer + i) = (float)tmp; //delay input
+
+            ol *= w; //wet
+
+            auto x1 = c + y * a + ol;
+#ifdef DEBUG
+            mda::checkSample(x1);
+#endif
+            out1[samp] = x1;
 
-    return true;
-  #endif
-}
+            if constexpr (stereoIn) {
+                auto x2 = d + y * b + ol;
+#ifdef DEBUG
+                mda::checkSample(x2);
 #endif
+                out2[samp] = x2;
+            } else if constexpr (stereoOut) {
+                out2[samp] = x1; // mono source, both sides are identical
+            }
+        }
 
-// recalculate on changed parameters
-void MdaDubDelayAudioProcessor::update(float fs)
-{
-    // get normalised values
-    auto delayValue = apvts.getParameter("delay")->getValue();
-    auto lfoDepthValue = apvts.getParameter("lfoDepth")->getValue();
-    auto feedbackToneValue = apvts.getParameter("feedbackTone")->getValue();
-    auto feedbackValue = apvts.getParameter("feedback")->getValue();
-    auto wetMixValue = apvts.getParameter("wetMix")->getValue();
-    auto outputValue = juce::Decibels::decibelsToGain(apvts.getParameter("output")->getValue());
-
-    del = delayValue * delayValue * allocatedBufferSize;
-    if (del > (float)allocatedBufferSize)
-        del = (float)allocatedBufferSize;
-    mod = 0.049f * lfoDepthValue * del;
-    
-    fil = feedbackToneValue;
-    if (fil>0.5f)  //simultaneously change crossover frequency & high/low mix
-    {
-      fil = 0.5f * fil - 0.25f;
-      lmix = -2.0f * fil;
-      hmix = 1.0f;
-    }
-    else
-    {
-      hmix = 2.0f * fil;
-      lmix = 1.0f - hmix;
+        // the taps only read, so they can follow the feedback loop as a second pass
+        if (tapsActive) {
+            addTaps<SampleType, stereoOut, hq>(out1 + start, stereoOut ? out2 + start : nullptr,
+                                               tapBase, tapDelay, wetRamp, todo);
+        }
     }
-    fil = expf(-juce::MathConstants<float>::twoPi * std::powf(10.0f, 2.2f + 4.5f * fil) / fs);
     
-    fbk = std::fabs(2.2f * feedbackValue - 1.1f);
-    if (feedbackValue>0.5f) {
-        rel=0.9997f;
-    }
-    else
-    {
-        rel=0.8f; //limit or clip
+    st.ipos = i;
+    st.dlbuf = dl;
+    st.dlTarget = db;
+    st.dlStep = ddl;
+    st.phi = phi;
+    st.lfoCountdown = k;
+    st.xPrev[0] = xp;
+    st.xPrev[1] = xp2;
+    if (std::abs(f0)<(SampleType)1.0e-10) { //trap denormals
+        st.fil0 = 0.0;
+        st.env = 0.0;
+    } else {
+        st.fil0 = f0;
+        st.env = e;
     }
-    
-    wet = 1.0f - wetMixValue;
-    wet = outputValue * (1.0f - wet * wet); //-3dB at 50% mix
-    dry = outputValue * 2.0f * (1.0f - wetMixValue * wetMixValue);
-    
-    float lfoRateValue = std::exp(7.0f * lfoRateParam->get() - 4.0f);
-    dphi = 628.31853f * std::pow(10.0f, 3.0f * lfoRateValue - 2.0f) / fs; //100-sample steps
-    
-    outputLevelSmoother.setCurrentAndTargetValue(outputValue);
+    state = st;
 }
 
-void MdaDubDelayAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+// Catmull-Rom between positions l and l+1 of the delay, for offline renders
+float MdaDubDelayAudioProcessor::readCubic (long l, float x) const noexcept
 {
-    juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
-    
-    auto mainInputOutput = getBusBuffer (buffer, true, 0);
+    auto s = allocatedBufferSize;
+    auto* mybuffer = delayBuffer.get();
+    auto lm1 = (l == 0) ? s : l - 1;
+    auto lp1 = (l == s) ? 0 : l + 1;
+    auto lp2 = (lp1 == s) ? 0 : lp1 + 1;
+
+    auto y0 = mybuffer[lm1], y1 = mybuffer[l], y2 = mybuffer[lp1], y3 = mybuffer[lp2];
+    auto c1 = 0.5f * (y2 - y0);
+    auto c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+    auto c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+    return ((c3 * x + c2) * x + c1) * x + y1;
+}
 
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
-    
-    auto fs = (float)getSampleRate();
-    bool expected = true;
-    if (parametersChanged.compare_exchange_strong(expected, false)) {
-        update(fs);
+// audio thread, once per sub-block: returns false while the multi-tap mode is off & silent
+bool MdaDubDelayAudioProcessor::glideTaps() noexcept
+{
+    if (numTaps == 0 && ! tapsSounding)
+        return false;
+
+    float peak = 0.0f;
+    for (int t = 0; t < kMaxTaps; ++t) {
+        tapNow.ratio[t] += tapGlide * (tapTarget.ratio[t] - tapNow.ratio[t]);
+        tapNow.left[t] += tapGlide * (tapTarget.left[t] - tapNow.left[t]);
+        tapNow.right[t] += tapGlide * (tapTarget.right[t] - tapNow.right[t]);
+        peak = juce::jmax(peak, tapNow.left[t] + tapNow.right[t]);
     }
-    
-    float a, b, c, d;
-    float ol, w=wet, y=dry, fb=fbk, dl=dlbuf, db=dlbuf, ddl = 0.0f;
-    float lx=lmix, hx=hmix, f=fil, f0=fil0, tmp;
-    float e=env, g, r=rel; //limiter envelope, gain, release
-    long i=ipos, l, s=allocatedBufferSize, k=0;
-    
-    for (auto samp=0; samp < buffer.getNumSamples(); samp++)
+
+    tapsSounding = numTaps > 0 || peak > 1.0e-5f;
+    if (! tapsSounding)
+        tapNow = tapTarget; // faded out, settle on the zero gains
+    return true;
+}
+
+// every tap reads the one delay history at its fraction of the modulated delay,
+// the loop runs over all kMaxTaps lanes (unused taps have zero gain) so the
+// compiler vectorises the interpolation & panning, and emits gathers for the
+// reads where the target has them (AVX2)
+template <typename SampleType, bool stereoOut, bool hq>
+void MdaDubDelayAudioProcessor::addTaps(SampleType* out1, SampleType* out2, const long* base, const float* delay,
+                                        const float* wet, int numSamples) const noexcept
+{
+    auto* mybuffer = delayBuffer.get();
+    auto s = allocatedBufferSize;
+
+    for (auto j = 0; j < numSamples; j++)
     {
-        a = *mainInputOutput.getReadPointer (0, samp);
-        b = *mainInputOutput.getReadPointer (1, samp);
-        c = a;
-        d = b;
-        
-        if (k==0) //update delay length at slower rate (could be improved!)
+        float left = 0.0f, right = 0.0f;
+        for (auto t = 0; t < kMaxTaps; t++)
         {
-            db += 0.01f * (del - db - mod - mod * std::sinf(phi)); //smoothed delay+lfo
-            ddl = 0.01f * (db - dl); //linear step
-            phi+=dphi;
-            if (phi>juce::MathConstants<float>::twoPi) phi-=juce::MathConstants<float>::twoPi;
-            k=100;
+            auto pos = delay[j] * tapNow.ratio[t];
+            auto n = (long)pos;
+            auto x = pos - (float)n;
+            n += base[j]; if (n>s) n-=(s+1);
+
+            float y;
+            if constexpr (hq) {
+                y = readCubic(n, x);
+            } else {
+                auto n1 = (n==s) ? 0 : n + 1;
+                y = mybuffer[n] + x * (mybuffer[n1] - mybuffer[n]); //lin interp
+            }
+            left += y * tapNow.left[t];
+            right += y * tapNow.right[t];
         }
-        k--;
-        dl += ddl; //lin interp between points
- 
-        i--; if (i<0) i=s; //delay positions
-        
-        l = (long)dl;
-        tmp = dl - (float)l; //remainder
-        l += i; if (l>s) l-=(s+1);
-        
-        ol = *(mybuffer + l); //delay output
-        
-        l++; if (l>s) l=0;
-        ol += tmp * (*(mybuffer + l) - ol); //lin interp
-
-        tmp = a + fb * ol;
-        
-        f0 = f * (f0 - tmp) + tmp; //low-pass filter
-        tmp = lx * f0 + hx * tmp;
-        
-        g = (tmp<0.0f)? -tmp : tmp; //simple limiter
-        e *= r; if (g>e) e = g;
-        if (e>1.0f) tmp /= e;
-
-        *(mybuffer + i) = tmp; //delay input
-        
-        ol *= w; //wet
-        
-        auto x1 = c + y * a + ol;
-        auto x2 = d + y * b + ol;
-#if DEBUG
-        checkSample(x1);
-        checkSample(x2);
-        
-#else
-        *mainInputOutput.getWritePointer (0, samp) = x1;
-        *mainInputOutput.getWritePointer (1, samp) = x2;
+
+        if constexpr (stereoOut) {
+            out1[j] += (SampleType)(wet[j] * left);
+            out2[j] += (SampleType)(wet[j] * right);
+#ifdef DEBUG
+            mda::checkSample(out2[j]);
+#endif
+        } else {
+            out1[j] += (SampleType)(wet[j] * 0.70710678f * (left + right)); //centre taps at full gain
+        }
+#ifdef DEBUG
+        mda::checkSample(out1[j]);
 #endif
     }
-    
-    ipos = i;
-    dlbuf = dl;
-    
-    //trap denormals
-    if (fabsf(f0)<1.0e-10f) {
-        fil0=0.0f;
-        env=0.0f;
-    } else {
-        fil0=f0;
-        env = e;
-    }
-    
-    
-    
 }
 
 //==============================================================================
-bool MdaDubDelayAudioProcessor::hasEditor() const {
-    return true;
-}
-
 juce::AudioProcessorEditor* MdaDubDelayAudioProcessor::createEditor()
 {
     return new MdaDubDelayAudioProcessorEditor (*this, apvts);
 }
 
-//==============================================================================
-void MdaDubDelayAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
-{
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml (state.createXml());
-    copyXmlToBinary (*xml, destData);
-}
-
-void MdaDubDelayAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
-{
-    std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
-    if (xmlState.get() != nullptr) {
-        if (xmlState->hasTagName (apvts.state.getType())) {
-            apvts.replaceState (juce::ValueTree::fromXml (*xmlState));
-        }
-    }
-}
-
 //==============================================================================
 // This creates new instances of the plugin..
+// (left out when the processors are built into a host such as mdaBenchmark)
+#if ! MDA_EMBEDDED_PLUGINS
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new MdaDubDelayAudioProcessor();
 }
-
-juce::AudioProcessorValueTreeState::ParameterLayout MdaDubDelayAudioProcessor::createParameterLayout()
-{
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(ParameterID::delay,
-                                                           "Delay",
-                                                           juce::NormalisableRange<float>(0.0f, kMaxDelayTime, 0.1f),
-                                                           5.0f,
-                                                           juce::AudioParameterFloatAttributes().withLabel("s")));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(ParameterID::feedback,
-                                                           "Feedback",
-                                                           juce::NormalisableRange<float>(0.0f, 100.0, 0.1f),
-                                                           50.0f,
-                                                           juce::AudioParameterFloatAttributes().withLabel("%")));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(ParameterID::feedbackTone,
-                                                           "Feedback Tone",
-                                                           0.0f,
-                                                           1.0f,
-                                                           0.4f));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(ParameterID::lfoDepth,
-                                                           "LFO Depth",
-                                                           juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f),
-                                                           0.0f,
-                                                           juce::AudioParameterFloatAttributes().withLabel("%")));
-    auto lfoRateStringFromValue = [](float value, int)
-    {
-        float lfoHz = std::exp(7.0f * value - 4.0f);
-        return juce::String(lfoHz, 3);
-    };
-    layout.add(std::make_unique<juce::AudioParameterFloat>(ParameterID::lfoRate,
-                                                           "LFO Rate",
-                                                           juce::NormalisableRange<float>(),
-                                                           2.0f,
-                                                           juce::AudioParameterFloatAttributes()
-                                                           .withLabel("Hz")
-                                                           .withStringFromValueFunction(lfoRateStringFromValue)));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(ParameterID::wetMix,
-                                                           "FX Mix",
-                                                           juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f),
-                                                           50.0f,
-                                                           juce::AudioParameterFloatAttributes().withLabel("%")));
-    
-    layout.add(std::make_unique<juce::AudioParameterFloat>(ParameterID::output,
-                                                           "Output Level",
-                                                           juce::NormalisableRange<float>(-24.0f, 6.0f, 0.1f),
-                                                           0.0f,
-                                                           juce::AudioParameterFloatAttributes().withLabel("dB")));
-    
-    return layout;
-}
+#endif
@@ -10,93 +10,184 @@
 
 #include <JuceHeader.h>
 
+//==============================================================================
+// compile-time description of the plugin, see mda::Processor
+struct MdaDubDelayDescription
+{
+    static constexpr const char* name = "mdaDubDelay";
+    static constexpr const char* stateTag = "mdDD"; // identifies our binary state
+
+    static constexpr float kMaxDelayTime = 16.0f; // in seconds
+    static constexpr int kMaxTaps = 8; // multi-tap mode, extra reads of the one delay line
+
+    // parameter indices, in the order of the table below
+    enum ParameterIndex
+    {
+        kDelay, kFeedback, kFeedbackTone, kLfoDepth, kLfoRate, kWetMix, kOutput,
+        kTaps, kFirstTap, // time, gain & pan for each tap from here
+        kNumParameters = kFirstTap + 3 * kMaxTaps
+    };
+
+    enum TapField { kTapTime, kTapGain, kTapPan };
+    static constexpr int tapParameter (int tap, TapField field) { return kFirstTap + 3 * tap + field; }
+
+    static juce::String lfoRateToText(float value, int)
+    {
+        float lfoHz = std::exp(7.0f * value - 4.0f);
+        return juce::String(lfoHz, 3);
+    }
+
+    static constexpr mda::ParameterSpec parameters[] =
+    {
+        //  id              name              min    max             step   default  label
+        { "delay",          "Delay",          0.0f,  kMaxDelayTime,  0.1f,   5.0f,   "s" },
+        { "feedback",       "Feedback",       0.0f,  100.0f,         0.1f,  50.0f,   "%" },
+        { "feedbackTone",   "Feedback Tone",  0.0f,  1.0f,           0.0f,   0.4f },
+        { "lfoDepth",       "LFO Depth",      0.0f,  100.0f,         1.0f,   0.0f,   "%" },
+        { "lfoRate",        "LFO Rate",       0.0f,  1.0f,           0.0f,   2.0f,   "Hz", lfoRateToText },
+        { "wetMix",         "FX Mix",         0.0f,  100.0f,         1.0f,  50.0f,   "%" },
+        { "output",         "Output Level", -24.0f,  6.0f,           0.1f,   0.0f,   "dB" },
+        { "taps",           "Taps",           0.0f,  (float)kMaxTaps, 1.0f,  0.0f },
+        // tap times are a fraction of the delay, so the taps follow it and its lfo
+        { "tap1Time",       "Tap 1 Time",     0.0f,  100.0f,         0.1f,  12.5f,   "%" },
+        { "tap1Gain",       "Tap 1 Gain",     0.0f,  100.0f,         1.0f,  50.0f,   "%" },
+        { "tap1Pan",        "Tap 1 Pan",   -100.0f,  100.0f,         1.0f, -50.0f },
+        { "tap2Time",       "Tap 2 Time",     0.0f,  100.0f,         0.1f,  25.0f,   "%" },
+        { "tap2Gain",       "Tap 2 Gain",     0.0f,  100.0f,         1.0f,  50.0f,   "%" },
+        { "tap2Pan",        "Tap 2 Pan",   -100.0f,  100.0f,         1.0f,  50.0f },
+        { "tap3Time",       "Tap 3 Time",     0.0f,  100.0f,         0.1f,  37.5f,   "%" },
+        { "tap3Gain",       "Tap 3 Gain",     0.0f,  100.0f,         1.0f,  50.0f,   "%" },
+        { "tap3Pan",        "Tap 3 Pan",   -100.0f,  100.0f,         1.0f, -50.0f },
+        { "tap4Time",       "Tap 4 Time",     0.0f,  100.0f,         0.1f,  50.0f,   "%" },
+        { "tap4Gain",       "Tap 4 Gain",     0.0f,  100.0f,         1.0f,  50.0f,   "%" },
+        { "tap4Pan",        "Tap 4 Pan",   -100.0f,  100.0f,         1.0f,  50.0f },
+        { "tap5Time",       "Tap 5 Time",     0.0f,  100.0f,         0.1f,  62.5f,   "%" },
+        { "tap5Gain",       "Tap 5 Gain",     0.0f,  100.0f,         1.0f,  50.0f,   "%" },
+        { "tap5Pan",        "Tap 5 Pan",   -100.0f,  100.0f,         1.0f, -50.0f },
+        { "tap6Time",       "Tap 6 Time",     0.0f,  100.0f,         0.1f,  75.0f,   "%" },
+        { "tap6Gain",       "Tap 6 Gain",     0.0f,  100.0f,         1.0f,  50.0f,   "%" },
+        { "tap6Pan",        "Tap 6 Pan",   -100.0f,  100.0f,         1.0f,  50.0f },
+        { "tap7Time",       "Tap 7 Time",     0.0f,  100.0f,         0.1f,  87.5f,   "%" },
+        { "tap7Gain",       "Tap 7 Gain",     0.0f,  100.0f,         1.0f,  50.0f,   "%" },
+        { "tap7Pan",        "Tap 7 Pan",   -100.0f,  100.0f,         1.0f, -50.0f },
+        { "tap8Time",       "Tap 8 Time",     0.0f,  100.0f,         0.1f, 100.0f,   "%" },
+        { "tap8Gain",       "Tap 8 Gain",     0.0f,  100.0f,         1.0f,  50.0f,   "%" },
+        { "tap8Pan",        "Tap 8 Pan",   -100.0f,  100.0f,         1.0f,  50.0f },
+    };
+
+    // the first program is the original mda one, the others were added for this port;
+    // values left out are zero, which leaves the multi-tap mode off
+    static constexpr mda::Program<kNumParameters> programs[] =
+    {
+        //  name                    delay  fdbk   tone   depth  rate   mix    output taps
+        { "Dub Feedback Delay",   { 0.30f, 0.70f, 0.40f, 0.00f, 0.50f, 0.33f, 0.80f } },
+        { "Slapback",             { 0.08f, 0.55f, 0.50f, 0.00f, 0.50f, 0.30f, 0.80f } },
+        { "Tape Wobble",          { 0.25f, 0.75f, 0.30f, 0.35f, 0.45f, 0.40f, 0.80f } },
+        { "Runaway Dub",          { 0.35f, 0.95f, 0.25f, 0.05f, 0.40f, 0.45f, 0.75f } },
+        { "Thin Echo",            { 0.20f, 0.65f, 0.80f, 0.00f, 0.50f, 0.35f, 0.80f } },
+        { "Hard Limit Echo",      { 0.30f, 0.10f, 0.45f, 0.00f, 0.50f, 0.35f, 0.80f } },
+        { "Multi-Tap Rhythm",     { 0.30f, 0.45f, 0.45f, 0.00f, 0.50f, 0.40f, 0.80f, 0.50f,
+                                    // time  gain   pan for taps 1 to 4
+                                    0.250f, 0.60f, 0.20f,  0.375f, 0.40f, 0.80f,
+                                    0.500f, 0.50f, 0.30f,  0.750f, 0.35f, 0.70f } },
+    };
+
+    // everything update() derives from the parameters, as one immutable snapshot
+    struct Coefficients
+    {
+        float del, mod; // delay & lfo depth in samples
+        float fil, lmix, hmix; // crossover filter coeff, low & high mix
+        float fbk, rel; // feedback, limiter release
+        float wet, dry; // wet & dry mix, including output level
+        float dphi; // lfo step
+        int numTaps; // multi-tap mode when above zero
+        float tapRatio[kMaxTaps]; // tap delay as a fraction of the delay
+        float tapLeft[kMaxTaps], tapRight[kMaxTaps]; // tap gains, panned; zero for unused taps
+    };
+};
+
 //==============================================================================
 /**
 */
-class MdaDubDelayAudioProcessor  : public juce::AudioProcessor
+class MdaDubDelayAudioProcessor  : public mda::Processor<MdaDubDelayAudioProcessor, MdaDubDelayDescription>
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
-                            , private juce::ValueTree::Listener
 {
 public:
     //==============================================================================
     MdaDubDelayAudioProcessor();
     ~MdaDubDelayAudioProcessor() override;
 
-    //==============================================================================
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-   #ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
-   #endif
-
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
 
-    //==============================================================================
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    //==============================================================================
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
-
-    //==============================================================================
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
-
-    juce::AudioProcessorValueTreeState apvts { *this, &undoManager, "Parameters", createParameterLayout() };
-    
     void reset() override;
 
-
 private:
-    
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    void valueTreePropertyChanged(juce::ValueTree&, const juce::Identifier&) override
-    {
-        parametersChanged.store(true);
-    }
-    std::atomic<bool> parametersChanged { false };
-
-    juce::UndoManager undoManager;
+    friend class mda::Processor<MdaDubDelayAudioProcessor, MdaDubDelayDescription>;
 
-    
-    juce::AudioParameterFloat* delayParam;
-    juce::AudioParameterFloat* feedbackParam;
-    juce::AudioParameterFloat* feedbackToneParam;
-    juce::AudioParameterFloat* lfoDepthParam;
-    juce::AudioParameterFloat* lfoRateParam;
-    juce::AudioParameterFloat* wetMixParam;
-    juce::AudioParameterFloat* outputParam;
-    
-    juce::LinearSmoothedValue<float> outputLevelSmoother;
+    // coefficients ramp per sample, except the crossover which steps once per sub-block
+    // unless rendering in high quality
+    mda::RampedValue wetSmoother, drySmoother, feedbackSmoother; // output level is part of wet & dry
+    mda::RampedValue filterSmoother, lowMixSmoother, highMixSmoother;
+    float wetRamp[kSubBlockSize], dryRamp[kSubBlockSize], feedbackRamp[kSubBlockSize];
+    float filterRamp[kSubBlockSize], lowMixRamp[kSubBlockSize], highMixRamp[kSubBlockSize];
 
-    float *mybuffer = nullptr; // delay
+    mda::DspBuffer<float> delayBuffer; // positions run from 0 to allocatedBufferSize inclusive
     long allocatedBufferSize = 0;
-    long ipos = 0; // delay max time, pointer, left time, right time
-    
-    float wet, dry, fbk; // wet & dry mix
-    float lmix, hmix; // low & high mix
-    float fil; // crossover filter coeff
-    float fil0; // crossover filter buffer
-    float env, rel; // limiter (clipper when release is instant)
-    float del, mod, phi, dphi; // lfo
-    float dlbuf; // smoothed modulated delay
-
-    void update(float fs);
+
+    // everything the sample loop carries from one block to the next, loaded into
+    // registers at the start of a block and written back with a single copy
+    struct State
+    {
+        double fil0 = 0.0; // crossover filter buffer, double so double hosts keep full precision
+        double env = 0.0; // limiter envelope
+        float dlbuf = 0.0f; // smoothed modulated delay
+        float dlTarget = 0.0f, dlStep = 0.0f; // next delay+lfo point & linear step towards it
+        float phi = 0.0f; // lfo phase
+        long ipos = 0; // delay write position
+        long lfoCountdown = 0; // samples until the next delay+lfo point
+        double xPrev[2] = {}; // the last two limiter inputs, for the high quality detector
+    };
+    State state;
+
+    float rel = 0.0f; // limiter (clipper when release is instant)
+    float del = 0.0f, mod = 0.0f, dphi = 0.0f; // lfo
+
+    // multi-tap mode: tap times & gains glide towards their targets once per sub-block
+    struct Taps
+    {
+        float ratio[kMaxTaps] {}, left[kMaxTaps] {}, right[kMaxTaps] {};
+    };
+    Taps tapTarget, tapNow;
+    int numTaps = 0;
+    bool tapsSounding = false; // still fading out after the taps were switched off
+    float tapGlide = 1.0f; // one-pole coefficient per sub-block
+
+    // exp(-2pi * 10^(2.2 + 4.5 * x) / fs) for x in [0, 0.5], rebuilt when the sample rate changes
+    mda::MappingTable crossoverTable;
+    double crossoverTableRate = 0.0;
+
+    // mda::Processor hooks
+    void prepareResources(double sampleRate, int maximumBlockSize);
+    void prepareSmoothing(double sampleRate);
+    void pushMeters(int numSamples);
+    size_t dspHeapBytes() const noexcept;
+    void saveDspState(mda::DspStateWriter& writer) const;
+    bool loadDspState(mda::DspStateReader& reader);
+    void update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const;
+    void applyCoefficients(const Coefficients& c, int rampSamples);
+
+    // highQuality is set for offline renders: cubic delay interpolation, per-sample
+    // crossover smoothing and a limiter that also detects peaks between samples
+    template <typename SampleType, mda::ChannelLayout layout, bool hq>
+    void processChannels(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+    float readCubic(long l, float x) const noexcept;
+    bool glideTaps() noexcept;
+    template <typename SampleType, bool stereoOut, bool hq>
+    void addTaps(SampleType* out1, SampleType* out2, const long* base, const float* delay,
+                 const float* wet, int numSamples) const noexcept;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaDubDelayAudioProcessor)
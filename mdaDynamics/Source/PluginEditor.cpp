@@ -0,0 +1,17 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaDynamicsAudioProcessorEditor::MdaDynamicsAudioProcessorEditor (MdaDynamicsAudioProcessor& p)
+    : ProcessorEditor (p, { { "Gain Reduction", mda::BarMeter::Scale::decibels, -40.0f, 0.0f },
+                            { "Gate", mda::BarMeter::Scale::decibels, -60.0f, 0.0f } })
+{
+}
@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    The generic layout: one row per parameter, the level meters, then the
+    compressor & limiter gain and the gate.
+*/
+class MdaDynamicsAudioProcessorEditor  : public mda::ProcessorEditor<MdaDynamicsAudioProcessor>
+{
+public:
+    explicit MdaDynamicsAudioProcessorEditor (MdaDynamicsAudioProcessor&);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaDynamicsAudioProcessorEditor)
+};
@@ -0,0 +1,263 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaDynamicsAudioProcessor::MdaDynamicsAudioProcessor()
+{
+    reset();
+}
+
+MdaDynamicsAudioProcessor::~MdaDynamicsAudioProcessor()
+{
+}
+
+//==============================================================================
+void MdaDynamicsAudioProcessor::prepareResources (double sampleRate, int)
+{
+    // the output is always delayed by the longest lookahead, reported once, and
+    // the lookahead only moves the detector's tap, so changing it never jumps
+    latency = (int)std::ceil(0.001 * kMaxLookahead * sampleRate);
+    reportLatency(latency);
+
+    // a sub-block is written before it is read
+    auto size = juce::nextPowerOfTwo(latency + kSubBlockSize + 1);
+    delayBuffer.allocate(2 * (size_t)size);
+    delayLines[0] = delayBuffer.get();
+    delayLines[1] = delayLines[0] + size;
+    delayMask = size - 1;
+}
+
+void MdaDynamicsAudioProcessor::prepareSmoothing (double sampleRate)
+{
+    trimSmoother.reset(sampleRate, kSmoothingTime);
+    drySmoother.reset(sampleRate, kSmoothingTime);
+}
+
+void MdaDynamicsAudioProcessor::reset()
+{
+    delayBuffer.clear();
+    state = {};
+    lastGain = 1.0f;
+}
+
+// the live state for the optional snapshot in the saved state, in a fixed order
+void MdaDynamicsAudioProcessor::saveDspState (mda::DspStateWriter& writer) const
+{
+    writer.writeSamples(delayBuffer.get(), delayBuffer.getSize());
+    writer.write(state.writePos);
+    writer.write(state.env);
+    writer.write(state.peak);
+    writer.write(state.gate);
+}
+
+bool MdaDynamicsAudioProcessor::loadDspState (mda::DspStateReader& reader)
+{
+    State st;
+    auto ok = reader.readSamples(delayBuffer.get(), delayBuffer.getSize())
+           && reader.read(st.writePos) && reader.read(st.env) && reader.read(st.peak) && reader.read(st.gate)
+           && st.writePos >= 0 && st.writePos <= delayMask;
+
+    if (! ok)
+        return false;
+
+    state = st;
+    return true;
+}
+
+// recalculate the coefficients depending on the changed parameters,
+// called off the audio thread
+void MdaDynamicsAudioProcessor::update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const {
+    auto plain = [&](int i) { return parameters[i].convertFrom0to1(values[i]); };
+
+    // halving times to per-sample coefficients
+    auto halving = [fs](float seconds) { return std::exp2(-1.0f / (seconds * fs)); };
+
+    c.threshold = juce::Decibels::decibelsToGain(plain(kThreshold));
+    c.ratio = percentToRatio(plain(kRatio));
+    if (c.ratio < 0.0f && c.threshold < 0.1f) c.ratio *= c.threshold * 15.0f;
+
+    auto mix = values[kMix];
+    c.trim = juce::Decibels::decibelsToGain(plain(kOutput)) * mix;
+    c.dry = 1.0f - mix;
+
+    c.attack = 1.0f - halving(attackSeconds(plain(kAttack)));
+    c.release = halving(releaseSeconds(plain(kRelease)));
+
+    auto limit = plain(kLimiter);
+    c.limiter = limit >= kLimiterOff ? 0.0f : 0.99f * juce::Decibels::decibelsToGain((float)juce::roundToInt(limit));
+
+    auto gate = plain(kGateThreshold);
+    c.gate = gate <= kGateOff ? 0.0f : juce::Decibels::decibelsToGain(gate);
+    c.gateAttack = 1.0f - halving(gateAttackSeconds(plain(kGateAttack)));
+    c.gateDecay = halving(gateDecaySeconds(plain(kGateDecay)));
+
+    c.lookahead = juce::roundToInt(0.001f * plain(kLookahead) * fs);
+}
+
+// audio thread: start ramping towards a new snapshot, over the usual
+// smoothing time unless rampSamples is given
+void MdaDynamicsAudioProcessor::applyCoefficients(const Coefficients& c, int rampSamples) {
+    if (rampSamples < 0) {
+        trimSmoother.setTargetValue(c.trim);
+        drySmoother.setTargetValue(c.dry);
+    } else {
+        trimSmoother.setTargetValue(c.trim, rampSamples);
+        drySmoother.setTargetValue(c.dry, rampSamples);
+    }
+    threshold = c.threshold;
+    ratio = c.ratio;
+    attack = c.attack;
+    release = c.release;
+    limiter = c.limiter;
+    gateThreshold = c.gate;
+    gateAttack = c.gateAttack;
+    gateDecay = c.gateDecay;
+
+    lookahead = juce::jmin(c.lookahead, latency);
+}
+
+// the compressor & limiter gain and the gate for the editor
+void MdaDynamicsAudioProcessor::pushMeters (int numSamples)
+{
+    meters.push(numSamples, lastGain, gateThreshold > 0.0f ? state.gate : 1.0f);
+}
+
+// first pass: the peak of both channels through the compressor, limiter and
+// gate envelopes; attack or release is a select, not a branch
+template <bool stereo>
+void MdaDynamicsAudioProcessor::followEnvelopes (const float* in1, const float* in2, int numSamples) noexcept
+{
+    float e = state.env, e2 = state.peak, ge = state.gate;
+    float at = attack, re = release, xth = gateThreshold, ga = gateAttack, xr = gateDecay;
+
+    for (auto i = 0; i < numSamples; i++)
+    {
+        auto x = std::abs(in1[i]);
+        if constexpr (stereo) {
+            x = juce::jmax(x, std::abs(in2[i]));
+        }
+
+        e = x > e ? e + at * (x - e) : e * re;
+        e2 = x > e ? x : e2 * re;
+        ge = e > xth ? ge + ga - ga * ge : ge * xr;
+
+        env[i] = e;
+        peak[i] = e2;
+        gate[i] = ge;
+    }
+
+    //anti-denormal
+    state.env = e < 1.0e-10f ? 0.0f : e;
+    state.peak = e2 < 1.0e-10f ? 0.0f : e2;
+    state.gate = ge < 1.0e-10f ? 0.0f : ge;
+}
+
+// second pass, on whole vectors: trim / (1 + ratio * (env / threshold - 1))
+// above the threshold, pulled down to the limiter's ceiling, times the gate,
+// plus the dry part of the mix
+void MdaDynamicsAudioProcessor::computeGain (int numSamples) noexcept
+{
+    juce::FloatVectorOperations::max(gain, env, threshold, numSamples);
+    juce::FloatVectorOperations::multiply(gain, ratio / threshold, numSamples);
+    juce::FloatVectorOperations::add(gain, 1.0f - ratio, numSamples);
+
+    // a negative ratio can take this through zero, which was silence in the original
+    for (auto i = 0; i < numSamples; i++) {
+        gain[i] = gain[i] > 0.0f ? trimRamp[i] / gain[i] : 0.0f;
+    }
+
+    if (limiter > 0.0f) {
+        // the ceiling over the peak envelope, in place
+        for (auto i = 0; i < numSamples; i++) {
+            peak[i] = limiter / juce::jmax(peak[i], 1.0e-10f);
+        }
+        juce::FloatVectorOperations::min(gain, gain, peak, numSamples);
+    }
+
+    if (gateThreshold > 0.0f) {
+        juce::FloatVectorOperations::multiply(gain, gate, numSamples);
+    }
+
+    lastGain = gain[numSamples - 1] / juce::jmax(trimRamp[numSamples - 1], 1.0e-10f);
+    juce::FloatVectorOperations::add(gain, dryRamp, numSamples);
+}
+
+// the input into the delay, envelopes from the detector's tap, then the gain
+// applied to the delay's output
+template <typename SampleType, mda::ChannelLayout layout, bool hq>
+void MdaDynamicsAudioProcessor::processChannels (juce::AudioBuffer<SampleType>& buffer, int numSamples)
+{
+    constexpr bool stereoIn = layout == mda::ChannelLayout::stereo;
+    constexpr bool stereoOut = layout != mda::ChannelLayout::mono;
+    constexpr int numChannels = stereoIn ? 2 : 1;
+
+    SampleType* channels[2] = { buffer.getWritePointer(0), stereoIn ? buffer.getWritePointer(1) : nullptr };
+
+    for (auto start = 0; start < numSamples; start += kSubBlockSize)
+    {
+        auto todo = juce::jmin(kSubBlockSize, numSamples - start);
+        trimSmoother.render(trimRamp, todo);
+        drySmoother.render(dryRamp, todo);
+
+        auto pos = state.writePos;
+        auto detectorTap = pos - latency + lookahead;
+        for (auto ch = 0; ch < numChannels; ch++) {
+            auto* x = channels[ch] + start;
+            auto* line = delayLines[ch];
+            for (auto j = 0; j < todo; j++) {
+                line[(pos + j) & delayMask] = (float)x[j];
+            }
+            for (auto j = 0; j < todo; j++) {
+                detector[ch][j] = line[(detectorTap + j) & delayMask];
+            }
+        }
+
+        followEnvelopes<stereoIn>(detector[0], detector[1], todo);
+        computeGain(todo);
+
+        for (auto ch = 0; ch < numChannels; ch++) {
+            auto* x = channels[ch] + start;
+            auto* line = delayLines[ch];
+            for (auto j = 0; j < todo; j++) {
+                x[j] = (SampleType)(line[(pos - latency + j) & delayMask] * gain[j]);
+            }
+        }
+        state.writePos = (pos + todo) & delayMask;
+
+#ifdef DEBUG
+        for (auto ch = 0; ch < numChannels; ch++) {
+            for (auto j = 0; j < todo; j++) {
+                mda::checkSample(channels[ch][start + j]);
+            }
+        }
+#endif
+    }
+
+    if constexpr (stereoOut && ! stereoIn) {
+        buffer.copyFrom(1, 0, buffer, 0, 0, numSamples);
+    }
+}
+
+//==============================================================================
+juce::AudioProcessorEditor* MdaDynamicsAudioProcessor::createEditor()
+{
+    return new MdaDynamicsAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+// (left out when the processors are built into a host such as mdaBenchmark)
+#if ! MDA_EMBEDDED_PLUGINS
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new MdaDynamicsAudioProcessor();
+}
+#endif
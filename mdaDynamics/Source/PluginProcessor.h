@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// compile-time description of the plugin, see mda::Processor
+struct MdaDynamicsDescription
+{
+    static constexpr const char* name = "mdaDynamics";
+    static constexpr const char* stateTag = "mdDy"; // identifies our binary state
+
+    // parameter indices, in the order of the table below
+    enum ParameterIndex
+    {
+        kThreshold, kRatio, kOutput, kAttack, kRelease, kLimiter,
+        kGateThreshold, kGateAttack, kGateDecay, kMix, kLookahead,
+        kNumParameters
+    };
+
+    static constexpr float kLimiterOff = 10.0f;
+    static constexpr float kGateOff = -60.0f;
+    static constexpr float kMaxLookahead = 5.0f; // ms
+
+    // the original's curve: gentle below the centre, infinity & beyond above
+    // it, negative (louder above the threshold) at the far left
+    static float percentToRatio(float percent)
+    {
+        auto r = 0.025f * percent - 0.5f;
+        if (r > 1.0f) r = 1.0f + 16.0f * (r - 1.0f) * (r - 1.0f);
+        if (r < 0.0f) r = 0.6f * r;
+        return r;
+    }
+
+    // the original's times were per-sample coefficients at 44.1kHz, these
+    // are the same times taken as halving times at any rate
+    static float coefficientToSeconds(double coefficient)
+    {
+        return (float)(-std::log10(2.0) / (44100.0 * std::log10(1.0 - coefficient)));
+    }
+
+    static float attackSeconds(float percent)       { return coefficientToSeconds(std::pow(10.0, -0.002 - 0.02 * percent)); }
+    static float releaseSeconds(float percent)      { return coefficientToSeconds(std::pow(10.0, -2.0 - 0.03 * percent)); }
+    static float gateAttackSeconds(float percent)   { return coefficientToSeconds(std::pow(10.0, -0.002 - 0.03 * percent)); }
+    static float gateDecaySeconds(float percent)    { return coefficientToSeconds(std::pow(10.0, -2.0 - 0.033 * percent)); }
+
+    static juce::String secondsToText(float seconds)
+    {
+        if (seconds < 0.001f)
+            return juce::String(juce::roundToInt(1.0e6f * seconds)) + " us";
+        if (seconds < 1.0f)
+            return juce::String(1000.0f * seconds, 1) + " ms";
+        return juce::String(seconds, 2) + " s";
+    }
+
+    static juce::String ratioToText(float value, int)
+    {
+        auto r = percentToRatio(value);
+        return r >= 1.0f ? juce::String("Infinity") : juce::String(1.0f / (1.0f - r), 2) + ":1";
+    }
+
+    static juce::String attackToText(float value, int)      { return secondsToText(attackSeconds(value)); }
+    static juce::String releaseToText(float value, int)     { return secondsToText(releaseSeconds(value)); }
+    static juce::String gateAttackToText(float value, int)  { return secondsToText(gateAttackSeconds(value)); }
+    static juce::String gateDecayToText(float value, int)   { return secondsToText(gateDecaySeconds(value)); }
+
+    static juce::String limiterToText(float value, int)
+    {
+        return value >= kLimiterOff ? juce::String("Off") : juce::String(juce::roundToInt(value)) + " dB";
+    }
+
+    static juce::String gateToText(float value, int)
+    {
+        return value <= kGateOff ? juce::String("Off") : juce::String(juce::roundToInt(value)) + " dB";
+    }
+
+    static constexpr mda::ParameterSpec parameters[] =
+    {
+        //  id              name            min         max           step   default  label
+        { "threshold",      "Threshold",   -40.0f,      0.0f,         0.1f, -16.0f,   "dB" },
+        { "ratio",          "Ratio",         0.0f,    100.0f,         1.0f,  40.0f,   "", ratioToText },
+        { "output",         "Output",        0.0f,     40.0f,         0.1f,   4.0f,   "dB" },
+        { "attack",         "Attack",        0.0f,    100.0f,         1.0f,  18.0f,   "", attackToText },
+        { "release",        "Release",       0.0f,    100.0f,         1.0f,  55.0f,   "", releaseToText },
+        // peak limiter, with the compressor's release
+        { "limiter",        "Limiter",     -20.0f,  kLimiterOff,      1.0f,   0.0f,   "", limiterToText },
+        { "gateThreshold",  "Gate Thresh",  kGateOff,   0.0f,         1.0f, kGateOff, "", gateToText },
+        { "gateAttack",     "Gate Attack",   0.0f,    100.0f,         1.0f,  10.0f,   "", gateAttackToText },
+        { "gateDecay",      "Gate Decay",    0.0f,    100.0f,         1.0f,  50.0f,   "", gateDecayToText },
+        { "mix",            "FX Mix",        0.0f,    100.0f,         1.0f, 100.0f,   "%" },
+        // the detector hears the input this much earlier than the gain is applied,
+        // the plugin's latency is the maximum whatever the setting
+        { "lookahead",      "Lookahead",     0.0f,  kMaxLookahead,    0.1f,   0.0f,   "ms" },
+    };
+
+    // the first program is the original mda one, the others were added for this port
+    static constexpr mda::Program<kNumParameters> programs[] =
+    {
+        //  name                    thresh ratio  output attack release limiter gate   g.att  g.dec  mix    lookahead
+        { "Dynamics",             { 0.60f, 0.40f, 0.10f, 0.18f, 0.55f, 0.667f, 0.00f, 0.10f, 0.50f, 1.00f, 0.0f } },
+        { "Gentle Bus Comp",      { 0.75f, 0.30f, 0.05f, 0.30f, 0.60f, 0.667f, 0.00f, 0.10f, 0.50f, 1.00f, 0.0f } },
+        { "Parallel Squash",      { 0.30f, 0.70f, 0.25f, 0.10f, 0.40f, 0.667f, 0.00f, 0.10f, 0.50f, 0.50f, 0.0f } },
+        { "Drum Gate",            { 1.00f, 0.20f, 0.00f, 0.18f, 0.30f, 0.667f, 0.40f, 0.05f, 0.30f, 1.00f, 0.4f } },
+        { "Lookahead Limiter",    { 1.00f, 0.20f, 0.15f, 0.18f, 0.45f, 0.633f, 0.00f, 0.10f, 0.50f, 1.00f, 0.4f } },
+    };
+
+    // everything update() derives from the parameters, as one immutable snapshot
+    struct Coefficients
+    {
+        float threshold, ratio, trim, dry;
+        float attack, release; // envelope coefficient & release multiplier
+        float limiter; // peak level, 0 for off
+        float gate, gateAttack, gateDecay; // threshold 0 for off
+        int lookahead; // samples
+    };
+};
+
+//==============================================================================
+/**
+*/
+class MdaDynamicsAudioProcessor  : public mda::Processor<MdaDynamicsAudioProcessor, MdaDynamicsDescription>
+                            #if JucePlugin_Enable_ARA
+                             , public juce::AudioProcessorARAExtension
+                            #endif
+{
+public:
+    //==============================================================================
+    MdaDynamicsAudioProcessor();
+    ~MdaDynamicsAudioProcessor() override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+
+    void reset() override;
+
+private:
+    friend class mda::Processor<MdaDynamicsAudioProcessor, MdaDynamicsDescription>;
+
+    // the output is delayed by the longest lookahead and the detector reads
+    // lookahead samples ahead of it, one power of two ring per channel
+    mda::DspBuffer<float> delayBuffer;
+    float* delayLines[2] = { nullptr, nullptr };
+    int delayMask = 0, latency = 0, lookahead = 0;
+    float detector[2][kSubBlockSize];
+
+    mda::RampedValue trimSmoother, drySmoother;
+    float trimRamp[kSubBlockSize], dryRamp[kSubBlockSize];
+
+    // per sub-block: envelopes from the first pass, gain from the second
+    float env[kSubBlockSize], peak[kSubBlockSize], gate[kSubBlockSize], gain[kSubBlockSize];
+
+    float threshold = 1.0f, ratio = 0.0f, attack = 1.0f, release = 0.0f;
+    float limiter = 0.0f, gateThreshold = 0.0f, gateAttack = 1.0f, gateDecay = 0.0f;
+
+    // everything the sample loop carries from one block to the next
+    struct State
+    {
+        int writePos = 0;
+        float env = 0.0f, peak = 0.0f, gate = 0.0f;
+    };
+    State state;
+    float lastGain = 1.0f; // compressor & limiter, for the meters
+
+    // mda::Processor hooks
+    void prepareResources(double sampleRate, int maximumBlockSize);
+    void prepareSmoothing(double sampleRate);
+    void pushMeters(int numSamples);
+    size_t dspHeapBytes() const noexcept { return delayBuffer.getHeapBytes(); }
+    void saveDspState(mda::DspStateWriter& writer) const;
+    bool loadDspState(mda::DspStateReader& reader);
+    void update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const;
+    void applyCoefficients(const Coefficients& c, int rampSamples);
+
+    template <bool stereo>
+    void followEnvelopes(const float* in1, const float* in2, int numSamples) noexcept;
+    void computeGain(int numSamples) noexcept;
+
+    template <typename SampleType, mda::ChannelLayout layout, bool hq>
+    void processChannels(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaDynamicsAudioProcessor)
+};
@@ -0,0 +1,17 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaLeslieAudioProcessorEditor::MdaLeslieAudioProcessorEditor (MdaLeslieAudioProcessor& p)
+    : ProcessorEditor (p, { { "Horn Hz", mda::BarMeter::Scale::linear, 0.0f, 10.0f },
+                            { "Drum Hz", mda::BarMeter::Scale::linear, 0.0f, 10.0f } })
+{
+}
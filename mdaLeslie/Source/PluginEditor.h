@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    The generic layout: one row per parameter, the level meters, then the
+    speeds of the horn and drum rotors.
+*/
+class MdaLeslieAudioProcessorEditor  : public mda::ProcessorEditor<MdaLeslieAudioProcessor>
+{
+public:
+    explicit MdaLeslieAudioProcessorEditor (MdaLeslieAudioProcessor&);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaLeslieAudioProcessorEditor)
+};
@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaLeslieAudioProcessor::MdaLeslieAudioProcessor()
+{
+    reset();
+}
+
+MdaLeslieAudioProcessor::~MdaLeslieAudioProcessor()
+{
+}
+
+//==============================================================================
+// room for the deepest horn sweep, twice fs / 760 samples
+void MdaLeslieAudioProcessor::prepareResources (double newSampleRate, int)
+{
+    sampleRate = (float)newSampleRate;
+    auto size = juce::nextPowerOfTwo((int)(2.0 * newSampleRate / 760.0) + 3);
+    dopplerBuffer.allocate(kNumRotors * (size_t)size);
+    dopplerMask = size - 1;
+}
+
+void MdaLeslieAudioProcessor::prepareSmoothing (double newSampleRate)
+{
+    gainSmoother.reset(newSampleRate, kSmoothingTime);
+}
+
+void MdaLeslieAudioProcessor::reset()
+{
+    dopplerBuffer.clear();
+    state = {};
+}
+
+// the live state for the optional snapshot in the saved state, in a fixed order
+void MdaLeslieAudioProcessor::saveDspState (mda::DspStateWriter& writer) const
+{
+    auto& st = state;
+    writer.writeSamples(dopplerBuffer.get(), dopplerBuffer.getSize());
+    writer.write(st.writePos);
+    writer.write(st.fb1);
+    writer.write(st.fb2);
+    for (auto r = 0; r < kNumRotors; r++) {
+        writer.write(st.cosPhase[r]);
+        writer.write(st.sinPhase[r]);
+        writer.write(st.speed[r]);
+    }
+}
+
+bool MdaLeslieAudioProcessor::loadDspState (mda::DspStateReader& reader)
+{
+    State st;
+    auto ok = reader.readSamples(dopplerBuffer.get(), dopplerBuffer.getSize())
+           && reader.read(st.writePos) && reader.read(st.fb1) && reader.read(st.fb2)
+           && st.writePos >= 0 && st.writePos <= dopplerMask;
+    for (auto r = 0; r < kNumRotors; r++) {
+        ok = ok && reader.read(st.cosPhase[r]) && reader.read(st.sinPhase[r]) && reader.read(st.speed[r]);
+    }
+
+    if (! ok)
+        return false;
+
+    state = st;
+    return true;
+}
+
+// recalculate the coefficients depending on the changed parameters,
+// called off the audio thread
+void MdaLeslieAudioProcessor::update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const {
+    // the original's rotor speeds in Hz at 100% and how sluggishly they get
+    // there, horn then drum
+    static constexpr float speeds[3][kNumRotors]   = { { 0.66f, 0.49f }, { 6.40f, 5.31f }, { 0.00f, 0.00f } };
+    static constexpr float momentum[3][kNumRotors] = { { 0.18f, 0.27f }, { 0.09f, 0.14f }, { 0.10f, 0.12f } };
+
+    auto mode = juce::roundToInt(parameters[kMode].convertFrom0to1(values[kMode]));
+    auto spd = juce::MathConstants<float>::twoPi / fs * 0.01f * parameters[kSpeed].convertFrom0to1(values[kSpeed]);
+
+    for (auto r = 0; r < kNumRotors; r++) {
+        // the original stepped its ramps every 32 samples, these run per sample
+        auto m = std::pow(10.0f, -1.0f / (32.0f * fs * momentum[mode][r]));
+        c.momentum[r] = m;
+        c.target[r] = speeds[mode][r] * spd * (1.0f - m);
+    }
+
+    c.gain = 0.4f * juce::Decibels::decibelsToGain(parameters[kOutput].convertFrom0to1(values[kOutput]));
+
+    c.width[kHorn] = values[kHiWidth] * values[kHiWidth];
+    c.width[kDrum] = values[kLoWidth] * values[kLoWidth];
+    c.throb[kHorn] = 0.9f * values[kHiThrob] * values[kHiThrob];
+    c.throb[kDrum] = 0.9f * values[kLoThrob] * values[kLoThrob];
+
+    // the drum's Doppler shift is a fixed, much smaller one than the horn's
+    c.depth[kHorn] = values[kHiDepth] * values[kHiDepth] * fs / 760.0f;
+    c.depth[kDrum] = 0.1f * fs / 760.0f;
+
+    auto hz = crossoverToHz(parameters[kCrossover].convertFrom0to1(values[kCrossover]));
+    c.crossover = std::exp(-juce::MathConstants<float>::twoPi * hz / fs);
+}
+
+// audio thread: start ramping towards a new snapshot, over the usual
+// smoothing time unless rampSamples is given; the rotors ramp to their new
+// speeds by themselves
+void MdaLeslieAudioProcessor::applyCoefficients(const Coefficients& c, int rampSamples) {
+    if (rampSamples < 0) {
+        gainSmoother.setTargetValue(c.gain);
+    } else {
+        gainSmoother.setTargetValue(c.gain, rampSamples);
+    }
+    for (auto r = 0; r < kNumRotors; r++) {
+        target[r] = c.target[r];
+        momentum[r] = c.momentum[r];
+        width[r] = c.width[r];
+        throb[r] = c.throb[r];
+        depth[r] = c.depth[r];
+    }
+    crossover = c.crossover;
+}
+
+// both rotors' speeds for the editor
+void MdaLeslieAudioProcessor::pushMeters (int numSamples)
+{
+    auto toHz = sampleRate / juce::MathConstants<float>::twoPi;
+    meters.push(numSamples, state.speed[kHorn] * toHz, state.speed[kDrum] * toHz);
+}
+
+// the crossover splits the mono input between the rotors, which then run as
+// two lanes: speed ramp, phase rotation, amplitude modulation and Doppler
+// delay, then the stereo spread from each rotor's sine
+template <typename SampleType, mda::ChannelLayout layout, bool hq>
+void MdaLeslieAudioProcessor::processChannels (juce::AudioBuffer<SampleType>& buffer, int numSamples)
+{
+    constexpr bool stereoIn = layout == mda::ChannelLayout::stereo;
+    constexpr bool stereoOut = layout != mda::ChannelLayout::mono;
+
+    // only the horn's modulation is cubed, for its sharper peak, and only the
+    // horn adds its Doppler copy to the direct sound like the original; the
+    // drum is replaced by its modulated read, so its level is unchanged
+    static constexpr float cubed[kNumRotors] = { 1.0f, 0.0f };
+    static constexpr float direct[kNumRotors] = { 1.0f, 0.0f };
+
+    auto* in1 = buffer.getReadPointer(0);
+    auto* in2 = stereoIn ? buffer.getReadPointer(1) : in1;
+    auto* out1 = buffer.getWritePointer(0);
+    auto* out2 = stereoOut ? buffer.getWritePointer(1) : nullptr;
+
+    auto st = state;
+    auto* ring = dopplerBuffer.get();
+    auto mask = dopplerMask;
+    auto fo = crossover;
+    alignas(8) float band[kNumRotors], mod[kNumRotors], y[kNumRotors];
+
+    for (auto start = 0; start < numSamples; start += kSubBlockSize)
+    {
+        auto todo = juce::jmin(kSubBlockSize, numSamples - start);
+        gainSmoother.render(gainRamp, todo);
+
+        // the recursion drifts off the unit circle very slowly, pull it back
+        for (auto r = 0; r < kNumRotors; r++) {
+            auto k = 1.5f - 0.5f * (st.cosPhase[r] * st.cosPhase[r] + st.sinPhase[r] * st.sinPhase[r]);
+            st.cosPhase[r] *= k;
+            st.sinPhase[r] *= k;
+        }
+
+        for (auto j = 0; j < todo; j++)
+        {
+            auto i = start + j;
+            auto a = (float)(in1[i] + in2[i]); //mono input
+
+            st.fb1 = fo * (st.fb1 - a) + a; //crossover
+            st.fb2 = fo * (st.fb2 - st.fb1) + st.fb1;
+            band[kHorn] = a - st.fb2;
+            band[kDrum] = st.fb2;
+
+            for (auto r = 0; r < kNumRotors; r++) {
+                st.speed[r] = momentum[r] * st.speed[r] + target[r]; //tend to required speed
+
+                // "magic circle" rotation, stable for any small speed without trig
+                st.cosPhase[r] -= st.speed[r] * st.sinPhase[r];
+                st.sinPhase[r] += st.speed[r] * st.cosPhase[r];
+
+                auto c = st.cosPhase[r];
+                mod[r] = c * (1.0f + cubed[r] * (c * c - 1.0f));
+                y[r] = gainRamp[j] * (1.0f - throb[r] * mod[r]) * band[r]; //volume
+            }
+
+            // both delays written as one frame, then read back at their own depths
+            ring[kNumRotors * st.writePos + kHorn] = y[kHorn];
+            ring[kNumRotors * st.writePos + kDrum] = y[kDrum];
+            auto base = (float)(st.writePos + mask + 1);
+
+            for (auto r = 0; r < kNumRotors; r++) {
+                auto pos = base - depth[r] * (1.0f + mod[r]);
+                auto p = (int)pos;
+                auto frac = pos - (float)p;
+                auto s0 = ring[kNumRotors * (p & mask) + r];
+                auto s1 = ring[kNumRotors * ((p + 1) & mask) + r];
+                y[r] = direct[r] * y[r] + s0 + frac * (s1 - s0); //linear interpolation
+            }
+            st.writePos = (st.writePos + 1) & mask;
+
+            auto mid = y[kHorn] + y[kDrum];
+            auto side = y[kHorn] * width[kHorn] * st.sinPhase[kHorn] - y[kDrum] * width[kDrum] * st.sinPhase[kDrum];
+            auto c = mid + side;
+            auto d = mid - side;
+#ifdef DEBUG
+            mda::checkSample(c);
+            mda::checkSample(d);
+#endif
+            if constexpr (stereoOut) {
+                out1[i] = (SampleType)c;
+                out2[i] = (SampleType)d;
+            } else {
+                out1[i] = (SampleType)mid;
+            }
+        }
+    }
+
+    //anti-denormal
+    if (std::abs(st.fb1) < 1.0e-10f) st.fb1 = 0.0f;
+    if (std::abs(st.fb2) < 1.0e-10f) st.fb2 = 0.0f;
+    state = st;
+}
+
+//==============================================================================
+juce::AudioProcessorEditor* MdaLeslieAudioProcessor::createEditor()
+{
+    return new MdaLeslieAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+// (left out when the processors are built into a host such as mdaBenchmark)
+#if ! MDA_EMBEDDED_PLUGINS
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new MdaLeslieAudioProcessor();
+}
+#endif
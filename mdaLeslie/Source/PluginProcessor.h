@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// compile-time description of the plugin, see mda::Processor
+struct MdaLeslieDescription
+{
+    static constexpr const char* name = "mdaLeslie";
+    static constexpr const char* stateTag = "mdLs"; // identifies our binary state
+
+    // parameter indices, in the order of the table below
+    enum ParameterIndex
+    {
+        kMode, kLoWidth, kLoThrob, kHiWidth, kHiDepth, kHiThrob, kCrossover, kOutput, kSpeed,
+        kNumParameters
+    };
+
+    enum Mode { kSlow, kFast, kStop };
+
+    // the rotors as lanes, processed side by side
+    enum Rotor { kHorn, kDrum, kNumRotors };
+
+    static juce::String modeToText(float value, int)
+    {
+        switch (juce::roundToInt(value)) {
+            case kSlow: return "Slow";
+            case kFast: return "Fast";
+            default:    return "Stop";
+        }
+    }
+
+    // the original's one pole crossover coefficient at 44.1kHz, as a frequency
+    static float crossoverToHz(float percent)
+    {
+        auto p = 0.01f * percent;
+        auto k = std::pow(10.0f, p * (2.27f - 0.54f * p) - 1.92f);
+        return -std::log(1.0f - k) * 44100.0f / juce::MathConstants<float>::twoPi;
+    }
+
+    static juce::String crossoverToText(float value, int)
+    {
+        return juce::String(juce::roundToInt(crossoverToHz(value))) + " Hz";
+    }
+
+    static constexpr mda::ParameterSpec parameters[] =
+    {
+        //  id          name          min      max     step   default  label
+        { "mode",       "Mode",        0.0f,    2.0f,  1.0f,   1.0f,   "", modeToText },
+        { "loWidth",    "Lo Width",    0.0f,  100.0f,  1.0f,  50.0f,   "%" },
+        { "loThrob",    "Lo Throb",    0.0f,  100.0f,  1.0f,  48.0f,   "%" },
+        { "hiWidth",    "Hi Width",    0.0f,  100.0f,  1.0f,  70.0f,   "%" },
+        { "hiDepth",    "Hi Depth",    0.0f,  100.0f,  1.0f,  60.0f,   "%" },
+        { "hiThrob",    "Hi Throb",    0.0f,  100.0f,  1.0f,  70.0f,   "%" },
+        { "crossover",  "X-Over",      0.0f,  100.0f,  1.0f,  50.0f,   "", crossoverToText },
+        { "output",     "Output",    -20.0f,   20.0f,  0.1f,   0.0f,   "dB" },
+        // fine tuning of both rotors' Slow & Fast speeds
+        { "speed",      "Speed",       0.0f,  200.0f,  1.0f, 120.0f,   "%" },
+    };
+
+    // the first program is the original mda one, the others were added for this port
+    static constexpr mda::Program<kNumParameters> programs[] =
+    {
+        //  name                      mode   lo wid lo thr hi wid hi dep hi thr x-over output speed
+        { "Leslie Simulator",       { 0.5f,  0.50f, 0.48f, 0.70f, 0.60f, 0.70f, 0.50f, 0.50f, 0.60f } },
+        { "Chorale",                { 0.0f,  0.50f, 0.48f, 0.70f, 0.60f, 0.70f, 0.50f, 0.50f, 0.60f } },
+        { "Slow Wide Cabinet",      { 0.0f,  0.80f, 0.30f, 1.00f, 0.45f, 0.50f, 0.45f, 0.50f, 0.45f } },
+        { "Screaming Horn",         { 0.5f,  0.40f, 0.60f, 0.80f, 0.90f, 0.85f, 0.60f, 0.50f, 0.70f } },
+        { "Parked Rotors",          { 1.0f,  0.50f, 0.48f, 0.70f, 0.60f, 0.70f, 0.50f, 0.50f, 0.60f } },
+    };
+
+    // everything update() derives from the parameters, as one immutable snapshot
+    struct Coefficients
+    {
+        float target[kNumRotors]; // speed the ramps head for, times 1 - momentum
+        float momentum[kNumRotors]; // per-sample one pole coefficients of the ramps
+        float width[kNumRotors], throb[kNumRotors], depth[kNumRotors];
+        float crossover, gain;
+    };
+};
+
+//==============================================================================
+/**
+*/
+class MdaLeslieAudioProcessor  : public mda::Processor<MdaLeslieAudioProcessor, MdaLeslieDescription>
+                            #if JucePlugin_Enable_ARA
+                             , public juce::AudioProcessorARAExtension
+                            #endif
+{
+public:
+    //==============================================================================
+    MdaLeslieAudioProcessor();
+    ~MdaLeslieAudioProcessor() override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+
+    void reset() override;
+
+private:
+    friend class mda::Processor<MdaLeslieAudioProcessor, MdaLeslieDescription>;
+
+    // the horn & drum Doppler delays interleaved in one ring, a frame per sample
+    mda::DspBuffer<float> dopplerBuffer;
+    int dopplerMask = 0;
+    float sampleRate = 44100.0f;
+
+    mda::RampedValue gainSmoother;
+    float gainRamp[kSubBlockSize];
+
+    alignas(8) float target[kNumRotors] = {}, momentum[kNumRotors] = {};
+    alignas(8) float width[kNumRotors] = {}, throb[kNumRotors] = {}, depth[kNumRotors] = {};
+    float crossover = 0.0f;
+
+    // everything the sample loop carries from one block to the next
+    struct State
+    {
+        int writePos = 0;
+        float fb1 = 0.0f, fb2 = 0.0f; // crossover
+        // the rotors' phases as points on the unit circle, and their speeds
+        // in radians per sample
+        alignas(8) float cosPhase[kNumRotors] = { 1.0f, 1.0f };
+        alignas(8) float sinPhase[kNumRotors] = {};
+        alignas(8) float speed[kNumRotors] = {};
+    };
+    State state;
+
+    // mda::Processor hooks
+    void prepareResources(double sampleRate, int maximumBlockSize);
+    void prepareSmoothing(double sampleRate);
+    void pushMeters(int numSamples);
+    size_t dspHeapBytes() const noexcept { return dopplerBuffer.getHeapBytes(); }
+    void saveDspState(mda::DspStateWriter& writer) const;
+    bool loadDspState(mda::DspStateReader& reader);
+    void update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const;
+    void applyCoefficients(const Coefficients& c, int rampSamples);
+
+    template <typename SampleType, mda::ChannelLayout layout, bool hq>
+    void processChannels(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaLeslieAudioProcessor)
+};
@@ -0,0 +1,10 @@
+/*
+  ==============================================================================
+
+    The mdaAmbience processor and editor, built into this app.
+
+  ==============================================================================
+*/
+
+#include "../../mdaAmbience/Source/PluginProcessor.cpp"
+#include "../../mdaAmbience/Source/PluginEditor.cpp"
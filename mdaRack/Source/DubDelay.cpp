@@ -0,0 +1,10 @@
+/*
+  ==============================================================================
+
+    The mdaDubDelay processor and editor, built into this app.
+
+  ==============================================================================
+*/
+
+#include "../../mdaDubDelay/Source/PluginProcessor.cpp"
+#include "../../mdaDubDelay/Source/PluginEditor.cpp"
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    Headless rack: N independent stereo channel strips, each a DubDelay into
+    an Ambience, processed block by block on a work-stealing thread pool as a
+    server-side stage would run them, then reports the throughput and how
+    many blocks missed their real-time deadline. Exits with 1 if any did, so
+    it can gate a load test.
+
+      mdaRack [--strips=64] [--threads=<cores>] [--pin] [--rate=48000]
+              [--block=512] [--seconds=10]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../mdaDubDelay/Source/PluginProcessor.h"
+#include "../../mdaAmbience/Source/PluginProcessor.h"
+#include "RackThreadPool.h"
+
+//==============================================================================
+// one stream through its own instances, nothing shared with the other strips
+struct ChannelStrip
+{
+    ChannelStrip (int index, double sampleRate, int blockSize)
+        : buffer (2, blockSize)
+    {
+        // different programs per strip, so the rack doesn't run one setting only
+        dubDelay.setCurrentProgram (index % dubDelay.getNumPrograms());
+        ambience.setCurrentProgram (index % ambience.getNumPrograms());
+
+        for (auto* processor : { (juce::AudioProcessor*) &dubDelay, (juce::AudioProcessor*) &ambience })
+        {
+            processor->setRateAndBufferSizeDetails (sampleRate, blockSize);
+            processor->prepareToPlay (sampleRate, blockSize);
+        }
+    }
+
+    ~ChannelStrip()
+    {
+        dubDelay.releaseResources();
+        ambience.releaseResources();
+    }
+
+    void process (const juce::AudioBuffer<float>& source, int sourcePosition)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            buffer.copyFrom (ch, 0, source, ch, sourcePosition, buffer.getNumSamples());
+
+        dubDelay.processBlock (buffer, midi);
+        ambience.processBlock (buffer, midi);
+    }
+
+    MdaDubDelayAudioProcessor dubDelay;
+    MdaAmbienceAudioProcessor ambience;
+    juce::AudioBuffer<float> buffer;
+    juce::MidiBuffer midi;
+};
+
+// a few seconds of decaying noise bursts, looped as every strip's input
+static juce::AudioBuffer<float> makeTestSignal (double sampleRate, int blockSize)
+{
+    auto numBlocks = juce::jmax (1, (int) (4.0 * sampleRate) / blockSize);
+    juce::AudioBuffer<float> signal (2, numBlocks * blockSize);
+    juce::Random random (1234);
+    auto burstLength = (int) (0.25 * sampleRate);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        auto* data = signal.getWritePointer (ch);
+        for (int i = 0; i < signal.getNumSamples(); ++i)
+        {
+            auto envelope = std::exp (-8.0f * (float) (i % burstLength) / (float) burstLength);
+            data[i] = 0.5f * envelope * (random.nextFloat() * 2.0f - 1.0f);
+        }
+    }
+    return signal;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+    juce::ScopedJuceInitialiser_GUI juceInitialiser; // the APVTS needs a message manager
+
+    auto option = [&args] (const char* name, double defaultValue)
+    {
+        auto value = args.getValueForOption (name);
+        return value.isEmpty() ? defaultValue : value.getDoubleValue();
+    };
+
+    auto numStrips = juce::jmax (1, (int) option ("--strips", 64));
+    auto numThreads = juce::jmax (1, (int) option ("--threads", juce::SystemStats::getNumCpus()));
+    auto pinToCores = args.containsOption ("--pin");
+    auto sampleRate = option ("--rate", 48000.0);
+    auto blockSize = juce::jmax (1, (int) option ("--block", 512));
+    auto seconds = option ("--seconds", 10.0);
+
+    std::cout << numStrips << " strips (DubDelay -> Ambience) on " << numThreads << " threads"
+              << (pinToCores ? " pinned to cores" : "") << ", " << blockSize << "-sample blocks at "
+              << sampleRate << " Hz" << std::endl;
+
+    std::vector<std::unique_ptr<ChannelStrip>> strips;
+    for (int i = 0; i < numStrips; ++i)
+        strips.push_back (std::make_unique<ChannelStrip> (i, sampleRate, blockSize));
+
+    auto signal = makeTestSignal (sampleRate, blockSize);
+    int position = 0;
+
+    RackThreadPool pool (numThreads, pinToCores, [&] (int index) { strips[(size_t) index]->process (signal, position); });
+
+    auto numBlocks = juce::jmax (1, (int) (seconds * sampleRate) / blockSize);
+    auto deadline = (double) blockSize / sampleRate;
+    double longestBlock = 0.0;
+    int misses = 0;
+
+    auto start = juce::Time::getHighResolutionTicks();
+
+    for (int block = 0; block < numBlocks; ++block)
+    {
+        auto blockStart = juce::Time::getHighResolutionTicks();
+        pool.run (numStrips);
+        auto blockTime = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - blockStart);
+
+        longestBlock = juce::jmax (longestBlock, blockTime);
+        if (blockTime > deadline)
+            ++misses;
+
+        position = (position + blockSize) % signal.getNumSamples();
+    }
+
+    auto elapsed = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+    auto audioSeconds = (double) numBlocks * blockSize / sampleRate;
+    auto realtimeFactor = audioSeconds / elapsed;
+
+    std::cout << "processed " << juce::String (audioSeconds, 1) << " s per strip in " << juce::String (elapsed, 2) << " s: "
+              << juce::String (realtimeFactor, 1) << "x realtime per strip, "
+              << juce::String ((double) numStrips * realtimeFactor, 0) << " realtime streams, "
+              << juce::String ((double) numStrips * audioSeconds * sampleRate / elapsed / 1.0e6, 2) << " M stereo frames/s" << std::endl
+              << "block time: mean " << juce::String (elapsed / numBlocks * 1000.0, 3) << " ms, max "
+              << juce::String (longestBlock * 1000.0, 3) << " ms, deadline " << juce::String (deadline * 1000.0, 3) << " ms, "
+              << misses << " misses (" << juce::String (100.0 * misses / numBlocks, 2) << "%)" << std::endl;
+
+    return misses > 0 ? 1 : 0;
+}
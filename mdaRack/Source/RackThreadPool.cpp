@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    RackThreadPool.cpp
+
+  ==============================================================================
+*/
+
+#include "RackThreadPool.h"
+
+//==============================================================================
+class RackThreadPool::Worker  : public juce::Thread
+{
+public:
+    Worker (RackThreadPool& p, int index)
+        : juce::Thread ("rack worker " + juce::String (index)), pool (p), threadIndex (index)
+    {
+        // realtime scheduling may need privileges the server doesn't have
+        if (! startRealtimeThread (juce::Thread::RealtimeOptions{}))
+            startThread (juce::Thread::Priority::highest);
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        wakeUp.signal();
+        stopThread (1000);
+    }
+
+    void signal() noexcept      { wakeUp.signal(); }
+
+    void run() override
+    {
+        if (pool.pinned)
+            setCurrentThreadAffinityMask (1u << (threadIndex % 32));
+
+        while (! threadShouldExit())
+        {
+            if (wakeUp.wait (100))
+                pool.work (threadIndex);
+        }
+    }
+
+private:
+    RackThreadPool& pool;
+    const int threadIndex;
+    juce::WaitableEvent wakeUp;
+
+    JUCE_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+RackThreadPool::RackThreadPool (int numThreads, bool pinToCores, Task taskToRun)
+    : task (std::move (taskToRun)), pinned (pinToCores), ranges ((size_t) juce::jmax (1, numThreads))
+{
+    for (auto& range : ranges)
+        range.store (0);
+
+    if (pinned)
+        juce::Thread::setCurrentThreadAffinityMask (1u);
+
+    for (int i = 1; i < getNumThreads(); ++i)
+        workers.push_back (std::make_unique<Worker> (*this, i));
+}
+
+RackThreadPool::~RackThreadPool()
+{
+    workers.clear();
+}
+
+void RackThreadPool::run (int numTasks)
+{
+    if (numTasks <= 0)
+        return;
+
+    // remaining goes first, a worker still stealing from the last block may
+    // pick up one of these as soon as the ranges are published
+    remaining.store (numTasks, std::memory_order_relaxed);
+
+    auto numThreads = getNumThreads();
+    for (int i = 0; i < numThreads; ++i)
+    {
+        auto begin = (juce::uint32) (numTasks * i / numThreads);
+        auto end = (juce::uint32) (numTasks * (i + 1) / numThreads);
+        ranges[(size_t) i].store (pack (begin, end), std::memory_order_release);
+    }
+
+    for (auto& worker : workers)
+        worker->signal();
+
+    work (0);
+
+    while (remaining.load (std::memory_order_acquire) > 0)
+        juce::Thread::yield();
+}
+
+bool RackThreadPool::popFront (int thread, int& index) noexcept
+{
+    auto& range = ranges[(size_t) thread];
+    auto current = range.load (std::memory_order_acquire);
+
+    for (;;)
+    {
+        auto begin = (juce::uint32) (current >> 32), end = (juce::uint32) current;
+        if (begin >= end)
+            return false;
+
+        if (range.compare_exchange_weak (current, pack (begin + 1, end), std::memory_order_acq_rel))
+        {
+            index = (int) begin;
+            return true;
+        }
+    }
+}
+
+bool RackThreadPool::stealBack (int thread, int& index) noexcept
+{
+    auto numThreads = getNumThreads();
+
+    for (int n = 1; n < numThreads; ++n)
+    {
+        auto& range = ranges[(size_t) ((thread + n) % numThreads)];
+        auto current = range.load (std::memory_order_acquire);
+
+        for (;;)
+        {
+            auto begin = (juce::uint32) (current >> 32), end = (juce::uint32) current;
+            if (begin >= end)
+                break;
+
+            if (range.compare_exchange_weak (current, pack (begin, end - 1), std::memory_order_acq_rel))
+            {
+                index = (int) end - 1;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void RackThreadPool::work (int thread)
+{
+    int index = 0;
+
+    while (popFront (thread, index) || stealBack (thread, index))
+    {
+        task (index);
+        remaining.fetch_sub (1, std::memory_order_acq_rel);
+    }
+}
@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    RackThreadPool.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    Runs one task per channel strip each block, spread over a fixed set of
+    threads with work stealing.
+
+    Every thread owns a contiguous range of strips, so a strip is processed on
+    the same core block after block while the load is even. A thread that runs
+    out of strips steals from the back of another thread's range, which evens
+    out slow strips and cores busy with something else. Each range is a begin
+    and an end packed into one atomic, taken from the front by its owner and
+    from the back by thieves, so nothing locks or allocates while processing.
+
+    The thread calling run() works as thread 0.
+*/
+class RackThreadPool
+{
+public:
+    using Task = std::function<void (int index)>;
+
+    /** pinToCores puts thread n on core n, where the platform allows it. */
+    RackThreadPool (int numThreads, bool pinToCores, Task taskToRun);
+    ~RackThreadPool();
+
+    /** Runs the task for every index in [0, numTasks) and returns once all have finished. */
+    void run (int numTasks);
+
+    int getNumThreads() const noexcept      { return (int) ranges.size(); }
+
+private:
+    class Worker;
+
+    bool popFront (int thread, int& task) noexcept;
+    bool stealBack (int thread, int& task) noexcept;
+    void work (int thread);
+
+    static juce::uint64 pack (juce::uint32 begin, juce::uint32 end) noexcept  { return ((juce::uint64) begin << 32) | end; }
+
+    Task task;
+    bool pinned;
+    std::vector<std::atomic<juce::uint64>> ranges; // per thread, begin << 32 | end
+    std::atomic<int> remaining { 0 };
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    JUCE_DECLARE_NON_COPYABLE (RackThreadPool)
+};
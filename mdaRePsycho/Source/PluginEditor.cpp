@@ -0,0 +1,17 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaRePsychoAudioProcessorEditor::MdaRePsychoAudioProcessorEditor (MdaRePsychoAudioProcessor& p)
+    : ProcessorEditor (p, { { "Event", mda::BarMeter::Scale::decibels, -60.0f, 0.0f },
+                            { "Position", mda::BarMeter::Scale::linear, 0.0f, 1.0f } })
+{
+}
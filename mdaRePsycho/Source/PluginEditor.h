@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    The generic layout: one row per parameter, the level meters, then the
+    current event's gain and how far it has played.
+*/
+class MdaRePsychoAudioProcessorEditor  : public mda::ProcessorEditor<MdaRePsychoAudioProcessor>
+{
+public:
+    explicit MdaRePsychoAudioProcessorEditor (MdaRePsychoAudioProcessor&);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaRePsychoAudioProcessorEditor)
+};
@@ -0,0 +1,221 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaRePsychoAudioProcessor::MdaRePsychoAudioProcessor()
+{
+    reset();
+}
+
+MdaRePsychoAudioProcessor::~MdaRePsychoAudioProcessor()
+{
+}
+
+//==============================================================================
+void MdaRePsychoAudioProcessor::prepareResources (double sampleRate, int)
+{
+    eventLength = (int)std::ceil(kEventSeconds * sampleRate);
+    eventBuffer.allocate(2 * (size_t)(eventLength + 1));
+    buffers[0] = eventBuffer.get();
+    buffers[1] = buffers[0] + eventLength + 1;
+    fadeStep = (float)(1.0 / std::ceil(kFadeSeconds * sampleRate));
+}
+
+void MdaRePsychoAudioProcessor::prepareSmoothing (double sampleRate)
+{
+    drySmoother.reset(sampleRate, kSmoothingTime);
+    wetSmoother.reset(sampleRate, kSmoothingTime);
+}
+
+// played out, so the first trigger isn't held off
+void MdaRePsychoAudioProcessor::reset()
+{
+    eventBuffer.clear();
+    state = {};
+    state.time = eventLength;
+}
+
+// the live state for the optional snapshot in the saved state, in a fixed order
+void MdaRePsychoAudioProcessor::saveDspState (mda::DspStateWriter& writer) const
+{
+    auto& st = state;
+    writer.writeSamples(eventBuffer.get(), eventBuffer.getSize());
+    writer.write(st.time);
+    for (auto v : { st.gain, st.x[0], st.x[1], st.fadeFrom[0], st.fadeFrom[1] }) {
+        writer.write(v);
+    }
+}
+
+bool MdaRePsychoAudioProcessor::loadDspState (mda::DspStateReader& reader)
+{
+    State st;
+    auto ok = reader.readSamples(eventBuffer.get(), eventBuffer.getSize())
+           && reader.read(st.time) && st.time >= 0 && st.time <= eventLength;
+    for (auto* v : { &st.gain, &st.x[0], &st.x[1], &st.fadeFrom[0], &st.fadeFrom[1] }) {
+        ok = ok && reader.read(*v);
+    }
+
+    if (! ok)
+        return false;
+
+    state = st;
+    return true;
+}
+
+// recalculate the coefficients depending on the changed parameters,
+// called off the audio thread
+void MdaRePsychoAudioProcessor::update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const {
+    auto plain = [&](int i) { return parameters[i].convertFrom0to1(values[i]); };
+
+    c.tune = std::exp2((plain(kTune) + 0.01f * plain(kFine)) / 12.0f);
+
+    // the original's per-sample curve at 44.1kHz, the same per second at any rate
+    auto d = values[kDecay] - 0.5f;
+    auto d5 = d * d * d * d * d;
+    auto perSample = d > 0.0f ? 1.0 + 0.003 * d5 : 1.0 + 0.025 * d5;
+    c.decay = (float)std::pow(perSample, 44100.0 / fs);
+
+    c.threshold = juce::Decibels::decibelsToGain(plain(kThreshold));
+    c.hold = juce::roundToInt(0.001f * plain(kHold) * fs);
+
+    auto mix = values[kMix];
+    c.highQuality = values[kQuality] > 0.5f;
+    c.dry = std::sqrt(1.0f - mix);
+    c.wet = 0.5f * std::sqrt(mix) * (c.highQuality ? 2.0f : 1.0f); // low quality records the channels summed
+}
+
+// audio thread: start ramping towards a new snapshot, over the usual
+// smoothing time unless rampSamples is given
+void MdaRePsychoAudioProcessor::applyCoefficients(const Coefficients& c, int rampSamples) {
+    if (rampSamples < 0) {
+        drySmoother.setTargetValue(c.dry);
+        wetSmoother.setTargetValue(c.wet);
+    } else {
+        drySmoother.setTargetValue(c.dry, rampSamples);
+        wetSmoother.setTargetValue(c.wet, rampSamples);
+    }
+    tune = c.tune;
+    decay = c.decay;
+    threshold = c.threshold;
+    hold = c.hold;
+    interpolate = c.highQuality;
+}
+
+// the current event's gain and how far it has played, for the editor
+void MdaRePsychoAudioProcessor::pushMeters (int numSamples)
+{
+    meters.push(numSamples, state.gain, (float)state.time / (float)eventLength);
+}
+
+// every sample is recorded and played back the same way, whether an event
+// has just fired, is playing or has played out: the trigger, the restart and
+// the end of the event are selects, so nothing branches on the signal
+template <typename SampleType, bool stereo, bool interpolated>
+void MdaRePsychoAudioProcessor::processEvents (const SampleType* in1, const SampleType* in2, SampleType* out1, SampleType* out2,
+                                               int numSamples) noexcept
+{
+    constexpr int numChannels = stereo ? 2 : 1;
+
+    auto st = state;
+    auto last = eventLength;
+    auto tu = tune, en = decay, thr = threshold, fa = fadeStep;
+    auto ho = hold;
+
+    for (auto start = 0; start < numSamples; start += kSubBlockSize)
+    {
+        auto todo = juce::jmin(kSubBlockSize, numSamples - start);
+        drySmoother.render(dryRamp, todo);
+        wetSmoother.render(wetRamp, todo);
+
+        for (auto j = 0; j < todo; j++)
+        {
+            auto i = start + j;
+            float in[2] = { (float)in1[i], (float)in2[i] };
+
+            auto trigger = (in[0] + in[1] > thr) & (st.time > ho);
+            st.gain = trigger ? 1.0f : st.gain;
+            st.time = trigger ? 0 : st.time;
+
+            // played out events keep recording into the guard sample
+            auto playing = st.time < last;
+            auto t = st.time;
+            auto pos = (float)juce::jmin(t, last - 1) * tu;
+            auto p = (int)pos;
+            auto fade = juce::jmin((float)t * fa, 1.0f);
+
+            for (auto ch = 0; ch < numChannels; ch++)
+            {
+                auto* buf = buffers[ch];
+                st.fadeFrom[ch] = trigger ? st.x[ch] : st.fadeFrom[ch]; //save for crossfade
+                buf[t] = stereo || interpolated ? in[ch] : in[0] + in[1];
+
+                float s;
+                if constexpr (interpolated) {
+                    s = buf[p] + (pos - (float)p) * (buf[p + 1] - buf[p]);
+                } else {
+                    s = buf[p];
+                }
+                st.x[ch] = st.fadeFrom[ch] + fade * (s - st.fadeFrom[ch]); //fade in
+            }
+
+            st.gain = playing ? st.gain * en : 0.0f;
+            st.time += playing ? 1 : 0;
+
+            auto g = wetRamp[j] * st.gain;
+            auto c = dryRamp[j] * in[0] + g * st.x[0];
+            auto d = dryRamp[j] * in[1] + g * st.x[numChannels - 1];
+#ifdef DEBUG
+            mda::checkSample(c);
+            mda::checkSample(d);
+#endif
+            out1[i] = (SampleType)c;
+            if (out2 != nullptr) {
+                out2[i] = (SampleType)d;
+            }
+        }
+    }
+
+    state = st;
+}
+
+template <typename SampleType, mda::ChannelLayout layout, bool hq>
+void MdaRePsychoAudioProcessor::processChannels (juce::AudioBuffer<SampleType>& buffer, int numSamples)
+{
+    constexpr bool stereoIn = layout == mda::ChannelLayout::stereo;
+    constexpr bool stereoOut = layout != mda::ChannelLayout::mono;
+
+    auto* in1 = buffer.getReadPointer(0);
+    auto* in2 = stereoIn ? buffer.getReadPointer(1) : in1;
+    auto* out1 = buffer.getWritePointer(0);
+    auto* out2 = stereoOut ? buffer.getWritePointer(1) : nullptr;
+
+    if (interpolate) {
+        processEvents<SampleType, stereoIn, true>(in1, in2, out1, out2, numSamples);
+    } else {
+        processEvents<SampleType, false, false>(in1, in2, out1, out2, numSamples);
+    }
+}
+
+//==============================================================================
+juce::AudioProcessorEditor* MdaRePsychoAudioProcessor::createEditor()
+{
+    return new MdaRePsychoAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+// (left out when the processors are built into a host such as mdaBenchmark)
+#if ! MDA_EMBEDDED_PLUGINS
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new MdaRePsychoAudioProcessor();
+}
+#endif
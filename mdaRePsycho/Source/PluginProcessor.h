@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// compile-time description of the plugin, see mda::Processor
+struct MdaRePsychoDescription
+{
+    static constexpr const char* name = "mdaRePsycho";
+    static constexpr const char* stateTag = "mdRP"; // identifies our binary state
+
+    // parameter indices, in the order of the table below
+    enum ParameterIndex
+    {
+        kTune, kFine, kDecay, kThreshold, kHold, kMix, kQuality,
+        kNumParameters
+    };
+
+    static constexpr double kEventSeconds = 0.5; // longest event, 22050 samples in the original
+    static constexpr double kFadeSeconds = 80.0 / 44100.0; // each event's fade in
+
+    static juce::String qualityToText(float value, int)
+    {
+        return value < 0.5f ? "Low" : "High";
+    }
+
+    static constexpr mda::ParameterSpec parameters[] =
+    {
+        //  id          name          min      max     step   default  label
+        { "tune",       "Tune",      -24.0f,    0.0f,  1.0f,   0.0f,   "semi" },
+        { "fine",       "Fine",      -99.0f,    0.0f,  1.0f,   0.0f,   "cents" },
+        // each event fades away or swells by this much
+        { "decay",      "Decay",     -50.0f,   50.0f,  1.0f,   0.0f,   "%" },
+        { "threshold",  "Threshold", -30.0f,    0.0f,  1.0f, -12.0f,   "dB" },
+        // shortest time between events
+        { "hold",       "Hold",       10.0f,  260.0f,  1.0f, 122.0f,   "ms" },
+        { "mix",        "Mix",         0.0f,  100.0f,  1.0f, 100.0f,   "%" },
+        { "quality",    "Quality",     0.0f,    1.0f,  1.0f,   0.0f,   "", qualityToText },
+    };
+
+    // the first program is the original mda one, the others were added for this port
+    static constexpr mda::Program<kNumParameters> programs[] =
+    {
+        //  name                      tune   fine   decay  thresh hold   mix    quality
+        { "Re-PsYcHo!",             { 1.00f, 1.00f, 0.50f, 0.60f, 0.45f, 1.00f, 0.0f } },
+        { "Octave Drop",            { 0.50f, 1.00f, 0.35f, 0.60f, 0.45f, 1.00f, 1.0f } },
+        { "Tape Stop Hits",         { 0.75f, 0.50f, 0.20f, 0.50f, 0.70f, 0.80f, 1.0f } },
+        { "Subtle Thump",           { 0.96f, 1.00f, 0.40f, 0.70f, 0.30f, 0.40f, 1.0f } },
+    };
+
+    // everything update() derives from the parameters, as one immutable snapshot
+    struct Coefficients
+    {
+        float tune; // playback speed, 1 or slower
+        float decay; // per-sample gain multiplier during an event
+        float threshold;
+        int hold; // samples
+        float dry, wet;
+        bool highQuality; // stereo & interpolated, rather than mono & truncated
+    };
+};
+
+//==============================================================================
+/**
+*/
+class MdaRePsychoAudioProcessor  : public mda::Processor<MdaRePsychoAudioProcessor, MdaRePsychoDescription>
+                            #if JucePlugin_Enable_ARA
+                             , public juce::AudioProcessorARAExtension
+                            #endif
+{
+public:
+    //==============================================================================
+    MdaRePsychoAudioProcessor();
+    ~MdaRePsychoAudioProcessor() override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+
+    void reset() override;
+
+private:
+    friend class mda::Processor<MdaRePsychoAudioProcessor, MdaRePsychoDescription>;
+
+    // an event is recorded from its trigger onwards and played back slower
+    // from the same buffer, one per channel, sized by prepareToPlay
+    mda::DspBuffer<float> eventBuffer;
+    float* buffers[2] = { nullptr, nullptr };
+    int eventLength = 1; // samples; each buffer has a guard sample after this
+    float fadeStep = 1.0f;
+
+    mda::RampedValue drySmoother, wetSmoother;
+    float dryRamp[kSubBlockSize], wetRamp[kSubBlockSize];
+    float tune = 1.0f, decay = 1.0f, threshold = 1.0f;
+    int hold = 1;
+    bool interpolate = false;
+
+    // everything the sample loop carries from one block to the next
+    struct State
+    {
+        int time = 0; // since the trigger, eventLength once played out
+        float gain = 0.0f;
+        float x[2] = {}, fadeFrom[2] = {}; // last output, and where the fade in starts
+    };
+    State state;
+
+    // mda::Processor hooks
+    void prepareResources(double sampleRate, int maximumBlockSize);
+    void prepareSmoothing(double sampleRate);
+    void pushMeters(int numSamples);
+    size_t dspHeapBytes() const noexcept { return eventBuffer.getHeapBytes(); }
+    void saveDspState(mda::DspStateWriter& writer) const;
+    bool loadDspState(mda::DspStateReader& reader);
+    void update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const;
+    void applyCoefficients(const Coefficients& c, int rampSamples);
+
+    template <typename SampleType, bool stereo, bool interpolated>
+    void processEvents(const SampleType* in1, const SampleType* in2, SampleType* out1, SampleType* out2, int numSamples) noexcept;
+
+    template <typename SampleType, mda::ChannelLayout layout, bool hq>
+    void processChannels(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaRePsychoAudioProcessor)
+};
@@ -0,0 +1,17 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaShepardAudioProcessorEditor::MdaShepardAudioProcessorEditor (MdaShepardAudioProcessor& p)
+    : ProcessorEditor (p, { { "Cycle", mda::BarMeter::Scale::linear, 0.0f, 1.0f },
+                            { "Tones", mda::BarMeter::Scale::decibels, -60.0f, 0.0f } })
+{
+}
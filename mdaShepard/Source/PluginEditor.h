@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    The generic layout: one row per parameter, the level meters, then the
+    place in the cycle and the level of the tones.
+*/
+class MdaShepardAudioProcessorEditor  : public mda::ProcessorEditor<MdaShepardAudioProcessor>
+{
+public:
+    explicit MdaShepardAudioProcessorEditor (MdaShepardAudioProcessor&);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaShepardAudioProcessorEditor)
+};
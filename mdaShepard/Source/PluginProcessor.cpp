@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+// the waveforms' band-limited tables, built by the first instance
+static const mda::BandLimitedWavetable& sharedWaveform (int index)
+{
+    static const mda::BandLimitedWavetable sine { [] (int n) { return n == 1 ? 1.0f : 0.0f; } };
+    static const mda::BandLimitedWavetable triangle { [] (int n) { return (n & 1) == 0 ? 0.0f : ((n & 2) == 0 ? 1.0f : -1.0f) / (float)(n * n); } };
+    static const mda::BandLimitedWavetable saw { [] (int n) { return 1.0f / (float)n; } };
+
+    switch (index) {
+        case MdaShepardDescription::kSine:      return sine;
+        case MdaShepardDescription::kTriangle:  return triangle;
+        default:                                return saw;
+    }
+}
+
+// a Gaussian over the cycle, lowered & rescaled to reach 0 at both ends so the
+// partials come and go silently; as a table, for a lookup per partial per
+// sub-block rather than an exp()
+static constexpr int kWeightTableSize = 256;
+
+static const auto weightTable = []
+{
+    constexpr double sigma = 1.0 / 6.0;
+    auto edge = std::exp(-0.5 / (4.0 * sigma * sigma));
+    std::array<float, kWeightTableSize + 2> table {};
+    for (auto i = 0; i <= kWeightTableSize; i++) {
+        auto d = ((double)i / kWeightTableSize - 0.5) / sigma;
+        table[(size_t)i] = (float)juce::jmax(0.0, (std::exp(-0.5 * d * d) - edge) / (1.0 - edge));
+    }
+    return table;
+}();
+
+// x is the place in the cycle, 0 to 1
+static float cycleWeight(float x) noexcept
+{
+    auto pos = x * (float)kWeightTableSize;
+    auto i = juce::jlimit(0, kWeightTableSize, (int)pos);
+    return weightTable[(size_t)i] + (pos - (float)i) * (weightTable[(size_t)i + 1] - weightTable[(size_t)i]);
+}
+
+//==============================================================================
+MdaShepardAudioProcessor::MdaShepardAudioProcessor()
+{
+    for (auto w = 0; w < kNumWaveforms; w++) {
+        waveforms[w] = &sharedWaveform(w);
+    }
+    reset();
+}
+
+MdaShepardAudioProcessor::~MdaShepardAudioProcessor()
+{
+}
+
+//==============================================================================
+void MdaShepardAudioProcessor::prepareSmoothing (double sampleRate)
+{
+    gainSmoother.reset(sampleRate, kSmoothingTime);
+}
+
+void MdaShepardAudioProcessor::reset()
+{
+    bank.reset();
+    state = {};
+    lastPeak = 0.0f;
+}
+
+// the live state for the optional snapshot in the saved state, in a fixed order
+void MdaShepardAudioProcessor::saveDspState (mda::DspStateWriter& writer) const
+{
+    writer.write(state.position);
+    bank.save(writer);
+}
+
+bool MdaShepardAudioProcessor::loadDspState (mda::DspStateReader& reader)
+{
+    State st;
+    auto ok = reader.read(st.position) && st.position >= 0.0f && st.position < (float)mda::OscillatorBank::maxPartials
+           && bank.load(reader);
+
+    if (! ok)
+        return false;
+
+    state = st;
+    return true;
+}
+
+// recalculate the coefficients depending on the changed parameters,
+// called off the audio thread
+void MdaShepardAudioProcessor::update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const {
+    auto plain = [&](int i) { return parameters[i].convertFrom0to1(values[i]); };
+
+    auto mode = juce::roundToInt(plain(kMode));
+    c.ring = mode == kRingMod ? 1.0f : 0.0f;
+    c.thru = mode == kTonesAndInput ? 1.0f : 0.0f;
+
+    c.numPartials = juce::roundToInt(plain(kPartials));
+    c.waveform = juce::roundToInt(plain(kWaveform));
+    c.rate = rateToOctaves(plain(kRate)) / fs;
+    c.lowest = centreToHz(plain(kCentre)) * std::exp2(-0.5f * (float)c.numPartials) / fs;
+
+    // the same loudness whatever the number of partials
+    auto power = 0.0f;
+    for (auto k = 0; k < c.numPartials; k++) {
+        auto w = cycleWeight(((float)k + 0.5f) / (float)c.numPartials);
+        power += w * w;
+    }
+    c.gain = 0.4f / std::sqrt(power) * juce::Decibels::decibelsToGain(plain(kOutput));
+}
+
+// audio thread: start ramping towards a new snapshot, over the usual
+// smoothing time unless rampSamples is given
+void MdaShepardAudioProcessor::applyCoefficients(const Coefficients& c, int rampSamples) {
+    if (rampSamples < 0) {
+        gainSmoother.setTargetValue(c.gain);
+    } else {
+        gainSmoother.setTargetValue(c.gain, rampSamples);
+    }
+    ring = c.ring;
+    thru = c.thru;
+    rate = c.rate;
+    lowest = c.lowest;
+    waveform = c.waveform;
+    numPartials = c.numPartials;
+    bank.setNumPartials(numPartials);
+}
+
+// where the cycle is, and the tones' level, for the editor
+void MdaShepardAudioProcessor::pushMeters (int numSamples)
+{
+    meters.push(numSamples, state.position / (float)numPartials, lastPeak);
+}
+
+// once per sub-block every partial gets its pitch and weight from its place
+// in the cycle, the bank renders them, then the tones are mixed with or
+// ring modulate the input
+template <typename SampleType, mda::ChannelLayout layout, bool hq>
+void MdaShepardAudioProcessor::processChannels (juce::AudioBuffer<SampleType>& buffer, int numSamples)
+{
+    constexpr bool stereoIn = layout == mda::ChannelLayout::stereo;
+    constexpr bool stereoOut = layout != mda::ChannelLayout::mono;
+
+    auto* in1 = buffer.getReadPointer(0);
+    auto* in2 = stereoIn ? buffer.getReadPointer(1) : in1;
+    auto* out1 = buffer.getWritePointer(0);
+    auto* out2 = stereoOut ? buffer.getWritePointer(1) : nullptr;
+
+    auto st = state;
+    auto& table = *waveforms[waveform];
+    auto cycle = (float)numPartials;
+    auto peak = 0.0f;
+
+    // the cycle may just have got shorter
+    if (st.position >= cycle) st.position = std::fmod(st.position, cycle);
+
+    for (auto start = 0; start < numSamples; start += kSubBlockSize)
+    {
+        auto todo = juce::jmin(kSubBlockSize, numSamples - start);
+        gainSmoother.render(gainRamp, todo);
+
+        // each partial wraps from the top of the cycle to the bottom, or the
+        // other way when falling, where its weight is 0
+        st.position += rate * (float)todo;
+        st.position -= st.position >= cycle ? cycle : 0.0f;
+        st.position += st.position < 0.0f ? cycle : 0.0f;
+
+        for (auto k = 0; k < numPartials; k++) {
+            auto u = (float)k + st.position;
+            u -= u >= cycle ? cycle : 0.0f;
+            bank.setPartial(k, table, lowest * std::exp2(u), cycleWeight(u / cycle));
+        }
+        bank.render(tone, todo);
+
+        auto range = juce::FloatVectorOperations::findMinAndMax(tone, todo);
+        peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+
+        for (auto j = 0; j < todo; j++)
+        {
+            auto i = start + j;
+            auto a = (float)in1[i];
+            auto b = (float)in2[i];
+            auto t = gainRamp[j] * tone[j];
+
+            auto c = t * (1.0f + ring * (a - 1.0f)) + thru * a;
+            auto d = t * (1.0f + ring * (b - 1.0f)) + thru * b;
+#ifdef DEBUG
+            mda::checkSample(c);
+            mda::checkSample(d);
+#endif
+            out1[i] = (SampleType)c;
+            if constexpr (stereoOut) {
+                out2[i] = (SampleType)d;
+            }
+        }
+    }
+
+    state = st;
+    lastPeak = peak;
+}
+
+//==============================================================================
+juce::AudioProcessorEditor* MdaShepardAudioProcessor::createEditor()
+{
+    return new MdaShepardAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+// (left out when the processors are built into a host such as mdaBenchmark)
+#if ! MDA_EMBEDDED_PLUGINS
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new MdaShepardAudioProcessor();
+}
+#endif
@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// compile-time description of the plugin, see mda::Processor
+struct MdaShepardDescription
+{
+    static constexpr const char* name = "mdaShepard";
+    static constexpr const char* stateTag = "mdSh"; // identifies our binary state
+
+    // parameter indices, in the order of the table below
+    enum ParameterIndex
+    {
+        kMode, kRate, kOutput, kPartials, kWaveform, kCentre,
+        kNumParameters
+    };
+
+    enum Mode { kTones, kRingMod, kTonesAndInput };
+    enum Waveform { kSine, kTriangle, kSaw, kNumWaveforms };
+
+    static juce::String modeToText(float value, int)
+    {
+        switch (juce::roundToInt(value)) {
+            case kTones:    return "Tones";
+            case kRingMod:  return "Ring Mod";
+            default:        return "Tones+In";
+        }
+    }
+
+    static juce::String waveformToText(float value, int)
+    {
+        switch (juce::roundToInt(value)) {
+            case kSine:     return "Sine";
+            case kTriangle: return "Triangle";
+            default:        return "Saw";
+        }
+    }
+
+    // the original's cubic curve, about 1.8 octaves a second either way at the ends
+    static float rateToOctaves(float percent)
+    {
+        auto r = 0.005f * percent;
+        return 14.427f * r * r * r;
+    }
+
+    static juce::String rateToText(float value, int)
+    {
+        return juce::String(rateToOctaves(value), 3) + " oct/s";
+    }
+
+    // where the loudest partials sit, 55Hz to 1760Hz
+    static float centreToHz(float percent)
+    {
+        return 55.0f * std::exp2(0.05f * percent);
+    }
+
+    static juce::String centreToText(float value, int)
+    {
+        return juce::String(juce::roundToInt(centreToHz(value))) + " Hz";
+    }
+
+    static constexpr mda::ParameterSpec parameters[] =
+    {
+        //  id          name          min      max     step   default  label
+        { "mode",       "Mode",        0.0f,    2.0f,  1.0f,   0.0f,   "", modeToText },
+        { "rate",       "Rate",     -100.0f,  100.0f,  1.0f,  40.0f,   "", rateToText },
+        { "output",     "Output",    -20.0f,   20.0f,  0.1f,   0.0f,   "dB" },
+        // octaves in the cycle, one partial each
+        { "partials",   "Partials",    8.0f,   16.0f,  1.0f,  10.0f,   "" },
+        { "waveform",   "Waveform",    0.0f,    2.0f,  1.0f,   0.0f,   "", waveformToText },
+        { "centre",     "Centre",      0.0f,  100.0f,  1.0f,  50.0f,   "", centreToText },
+    };
+
+    // the first program is the original mda one, the others were added for this port
+    static constexpr mda::Program<kNumParameters> programs[] =
+    {
+        //  name                      mode   rate   output partls wave   centre
+        { "Shepard Tones",          { 0.0f,  0.70f, 0.50f, 0.25f, 0.0f,  0.50f } },
+        { "Falling Forever",        { 0.0f,  0.30f, 0.50f, 0.50f, 0.5f,  0.40f } },
+        { "Ring Mod Spiral",        { 0.5f,  0.80f, 0.50f, 0.25f, 0.0f,  0.70f } },
+        { "Bright Ascent",          { 1.0f,  0.65f, 0.40f, 1.00f, 1.0f,  0.60f } },
+    };
+
+    // everything update() derives from the parameters, as one immutable snapshot
+    struct Coefficients
+    {
+        float ring, thru; // how much the input modulates, and is added to, the tones
+        float gain;
+        float rate; // octaves per sample
+        float lowest; // cycles per sample at the bottom of the cycle
+        int numPartials, waveform;
+    };
+};
+
+//==============================================================================
+/**
+*/
+class MdaShepardAudioProcessor  : public mda::Processor<MdaShepardAudioProcessor, MdaShepardDescription>
+                            #if JucePlugin_Enable_ARA
+                             , public juce::AudioProcessorARAExtension
+                            #endif
+{
+public:
+    //==============================================================================
+    MdaShepardAudioProcessor();
+    ~MdaShepardAudioProcessor() override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+
+    void reset() override;
+
+private:
+    friend class mda::Processor<MdaShepardAudioProcessor, MdaShepardDescription>;
+
+    // the partials, an octave apart and sliding through the cycle together
+    mda::OscillatorBank bank;
+    const mda::BandLimitedWavetable* waveforms[kNumWaveforms]; // shared by all instances
+
+    mda::RampedValue gainSmoother;
+    float gainRamp[kSubBlockSize], tone[kSubBlockSize];
+
+    float ring = 0.0f, thru = 0.0f, rate = 0.0f, lowest = 0.0f;
+    int numPartials = 1, waveform = kSine;
+
+    // everything the sample loop carries from one block to the next
+    struct State
+    {
+        float position = 0.0f; // how far the partials have moved through the cycle, in octaves
+    };
+    State state;
+    float lastPeak = 0.0f; // of the tones, for the meters
+
+    // mda::Processor hooks
+    void prepareSmoothing(double sampleRate);
+    void pushMeters(int numSamples);
+    void saveDspState(mda::DspStateWriter& writer) const;
+    bool loadDspState(mda::DspStateReader& reader);
+    void update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const;
+    void applyCoefficients(const Coefficients& c, int rampSamples);
+
+    template <typename SampleType, mda::ChannelLayout layout, bool hq>
+    void processChannels(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaShepardAudioProcessor)
+};
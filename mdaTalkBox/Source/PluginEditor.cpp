@@ -0,0 +1,17 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaTalkBoxAudioProcessorEditor::MdaTalkBoxAudioProcessorEditor (MdaTalkBoxAudioProcessor& p)
+    : ProcessorEditor (p, { { "LPC Order", mda::BarMeter::Scale::linear, 0.0f, (float) TalkBoxLpc::maxOrder },
+                            { "Formant Gain", mda::BarMeter::Scale::decibels, -60.0f, 6.0f } })
+{
+}
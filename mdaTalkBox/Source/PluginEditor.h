@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    The generic layout: one row per parameter, the level meters, then the
+    LPC order and the gain of the latest analysis frame.
+*/
+class MdaTalkBoxAudioProcessorEditor  : public mda::ProcessorEditor<MdaTalkBoxAudioProcessor>
+{
+public:
+    explicit MdaTalkBoxAudioProcessorEditor (MdaTalkBoxAudioProcessor&);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaTalkBoxAudioProcessorEditor)
+};
@@ -0,0 +1,241 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaTalkBoxAudioProcessor::MdaTalkBoxAudioProcessor()
+{
+    reset();
+}
+
+MdaTalkBoxAudioProcessor::~MdaTalkBoxAudioProcessor()
+{
+}
+
+//==============================================================================
+// about 16ms of the half rate signal the analysis runs at
+int MdaTalkBoxAudioProcessor::frameSizeFor (double sampleRate)
+{
+    auto fs = juce::jlimit(8000.0, 96000.0, sampleRate);
+    return juce::jmin((int)(0.01633 * fs), kMaxFrame);
+}
+
+int MdaTalkBoxAudioProcessor::orderFor (double sampleRate, float quality)
+{
+    auto fs = juce::jlimit(8000.0, 96000.0, sampleRate);
+    return juce::jlimit(1, TalkBoxLpc::maxOrder, (int)((0.0001 + 0.0004 * quality) * fs));
+}
+
+void MdaTalkBoxAudioProcessor::prepareResources (double sampleRate, int)
+{
+    frameBuffers.allocate(4 * (size_t)kFrameStride + (size_t)kMaxFrame);
+    buf0 = frameBuffers.get();
+    buf1 = buf0 + kFrameStride;
+    car0 = buf1 + kFrameStride;
+    car1 = car0 + kFrameStride;
+    window = car1 + kFrameStride;
+
+    N = frameSizeFor(sampleRate);
+    auto dp = juce::MathConstants<double>::twoPi / N;
+    for (auto n = 0; n < N; n++) {
+        window[n] = (float)(0.5 - 0.5 * std::cos(dp * n)); //hanning
+    }
+
+    lpc.prepare(N, orderFor(sampleRate, 1.0f));
+}
+
+void MdaTalkBoxAudioProcessor::prepareSmoothing (double sampleRate)
+{
+    wetSmoother.reset(sampleRate, kSmoothingTime);
+    drySmoother.reset(sampleRate, kSmoothingTime);
+}
+
+void MdaTalkBoxAudioProcessor::reset()
+{
+    state = {};
+    lastGain = 0.0f;
+    if (window != nullptr) {
+        juce::FloatVectorOperations::clear(buf0, 4 * kFrameStride); // not the window
+    }
+}
+
+// the live state for the optional snapshot in the saved state, in a fixed order
+void MdaTalkBoxAudioProcessor::saveDspState (mda::DspStateWriter& writer) const
+{
+    auto& st = state;
+    writer.write(st.pos);
+    writer.write(st.K);
+    for (auto v : { st.emphasis, st.FX, st.u0, st.u1, st.u2, st.u3, st.u4, st.d0, st.d1, st.d2, st.d3, st.d4 }) {
+        writer.write(v);
+    }
+    writer.writeSamples(buf0, 4 * (size_t)kFrameStride);
+}
+
+bool MdaTalkBoxAudioProcessor::loadDspState (mda::DspStateReader& reader)
+{
+    State st;
+    auto ok = reader.read(st.pos) && reader.read(st.K) && st.pos >= 0 && st.pos < N;
+    for (auto* v : { &st.emphasis, &st.FX, &st.u0, &st.u1, &st.u2, &st.u3, &st.u4, &st.d0, &st.d1, &st.d2, &st.d3, &st.d4 }) {
+        ok = ok && reader.read(*v);
+    }
+    ok = ok && reader.readSamples(buf0, 4 * (size_t)kFrameStride);
+
+    if (! ok)
+        return false;
+
+    state = st;
+    return true;
+}
+
+// recalculate the coefficients depending on the changed parameters,
+// called off the audio thread
+void MdaTalkBoxAudioProcessor::update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const {
+    c.wet = 0.5f * values[kWet] * values[kWet];
+    c.dry = 2.0f * values[kDry] * values[kDry];
+    c.carrier = juce::roundToInt(parameters[kCarrier].convertFrom0to1(values[kCarrier]));
+    c.order = orderFor(fs, values[kQuality]);
+}
+
+// audio thread: start ramping towards a new snapshot, over the usual
+// smoothing time unless rampSamples is given
+void MdaTalkBoxAudioProcessor::applyCoefficients(const Coefficients& c, int rampSamples) {
+    if (rampSamples < 0) {
+        wetSmoother.setTargetValue(c.wet);
+        drySmoother.setTargetValue(c.dry);
+    } else {
+        wetSmoother.setTargetValue(c.wet, rampSamples);
+        drySmoother.setTargetValue(c.dry, rampSamples);
+    }
+    carrier = c.carrier;
+    O = c.order;
+}
+
+// the LPC order & the latest frame's gain for the editor
+void MdaTalkBoxAudioProcessor::pushMeters (int numSamples)
+{
+    meters.push(numSamples, (float)O, lastGain);
+}
+
+// the analysis runs at half the sample rate, on two 50% overlapping frames
+// that are resynthesised in place whenever one fills up; the output is mono
+template <typename SampleType, mda::ChannelLayout layout, bool hq>
+void MdaTalkBoxAudioProcessor::processChannels (juce::AudioBuffer<SampleType>& buffer, int numSamples)
+{
+    constexpr bool stereoIn = layout == mda::ChannelLayout::stereo;
+    constexpr bool stereoOut = layout != mda::ChannelLayout::mono;
+
+    // modulator & carrier are each the average of two channels, which may be the
+    // same one; a carrier that isn't there is silent
+    auto* left = buffer.getReadPointer(0);
+    auto* right = stereoIn ? buffer.getReadPointer(1) : left;
+    const SampleType *modA = left, *modB = left, *carA = right, *carB = right;
+    float carGain = stereoIn ? 0.5f : 0.0f;
+
+    if (carrier == kCarrierLeft) {
+        modA = modB = right;
+        carA = carB = left;
+    } else if (carrier == kCarrierSidechain) {
+        auto sidechain = getBusBuffer(buffer, true, 1);
+        auto numSidechain = sidechain.getNumChannels();
+        modB = right;
+        carGain = numSidechain > 0 ? 0.5f : 0.0f;
+        if (numSidechain > 0) {
+            carA = sidechain.getReadPointer(0);
+            carB = sidechain.getReadPointer(numSidechain - 1);
+        }
+    }
+
+    auto* out1 = buffer.getWritePointer(0);
+    auto* out2 = stereoOut ? buffer.getWritePointer(1) : nullptr;
+
+    auto st = state;
+    long p0 = st.pos, p1 = (st.pos + N/2) % N, K = st.K;
+    float e = st.emphasis, w, o, x, dr, fx = st.FX;
+    float p, q, h0 = 0.3f, h1 = 0.77f;
+    float u0 = st.u0, u1 = st.u1, u2 = st.u2, u3 = st.u3, u4 = st.u4;
+    float d0 = st.d0, d1 = st.d1, d2 = st.d2, d3 = st.d3, d4 = st.d4;
+    auto gain = lastGain;
+
+    for (auto start = 0; start < numSamples; start += kSubBlockSize)
+    {
+        auto todo = juce::jmin(kSubBlockSize, numSamples - start);
+        wetSmoother.render(wetRamp, todo);
+        drySmoother.render(dryRamp, todo);
+
+        for (auto j = 0; j < todo; j++)
+        {
+            auto i = start + j;
+            o = 0.5f * (float)(modA[i] + modB[i]);
+            x = carGain * (float)(carA[i] + carB[i]);
+            dr = o;
+
+            p = d0 + h0 *  x; d0 = d1;  d1 = x  - h0 * p;
+            q = d2 + h1 * d4; d2 = d3;  d3 = d4 - h1 * q;
+            d4 = x;
+            x = p + q;
+
+            if (K++)
+            {
+                K = 0;
+
+                car0[p0] = car1[p1] = x; //carrier input
+
+                x = o - e;  e = o;  //6dB/oct pre-emphasis
+
+                w = window[p0]; fx = buf0[p0] * w;  buf0[p0] = x * w;  //50% overlapping hanning windows
+                if (++p0 >= N) { gain = lpc.process(buf0, car0, N, O);  p0 = 0; }
+
+                w = 1.0f - w;  fx += buf1[p1] * w;  buf1[p1] = x * w;
+                if (++p1 >= N) { lpc.process(buf1, car1, N, O);  p1 = 0; }
+            }
+
+            p = u0 + h0 * fx; u0 = u1;  u1 = fx - h0 * p;
+            q = u2 + h1 * u4; u2 = u3;  u3 = u4 - h1 * q;
+            u4 = fx;
+            x = p + q;
+
+            o = wetRamp[j] * x + dryRamp[j] * dr;
+#ifdef DEBUG
+            mda::checkSample(o);
+#endif
+            out1[i] = (SampleType)o;
+            if constexpr (stereoOut) {
+                out2[i] = (SampleType)o;
+            }
+        }
+    }
+
+    //anti-denormal
+    auto flush = [](float v) { return std::abs(v) < 1.0e-10f ? 0.0f : v; };
+    st.pos = p0;
+    st.K = K;
+    st.emphasis = e;
+    st.FX = fx;
+    st.u0 = flush(u0); st.u1 = flush(u1); st.u2 = flush(u2); st.u3 = flush(u3); st.u4 = flush(u4);
+    st.d0 = flush(d0); st.d1 = flush(d1); st.d2 = flush(d2); st.d3 = flush(d3); st.d4 = flush(d4);
+    state = st;
+    lastGain = gain;
+}
+
+//==============================================================================
+juce::AudioProcessorEditor* MdaTalkBoxAudioProcessor::createEditor()
+{
+    return new MdaTalkBoxAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+// (left out when the processors are built into a host such as mdaBenchmark)
+#if ! MDA_EMBEDDED_PLUGINS
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new MdaTalkBoxAudioProcessor();
+}
+#endif
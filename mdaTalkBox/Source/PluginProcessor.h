@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "TalkBoxLpc.h"
+
+//==============================================================================
+// compile-time description of the plugin, see mda::Processor
+struct MdaTalkBoxDescription
+{
+    static constexpr const char* name = "mdaTalkBox";
+    static constexpr const char* stateTag = "mdTB"; // identifies our binary state
+    static constexpr const char* sidechainName = "Carrier"; // the synth being "spoken" through
+
+    // parameter indices, in the order of the table below
+    enum ParameterIndex
+    {
+        kWet, kDry, kCarrier, kQuality,
+        kNumParameters
+    };
+
+    // the original took the carrier from one side of a stereo input
+    enum CarrierSource { kCarrierRight, kCarrierLeft, kCarrierSidechain };
+
+    static juce::String carrierToText(float value, int)
+    {
+        switch (juce::roundToInt(value)) {
+            case kCarrierRight: return "Right";
+            case kCarrierLeft:  return "Left";
+            default:            return "Sidechain";
+        }
+    }
+
+    static constexpr mda::ParameterSpec parameters[] =
+    {
+        //  id          name         min    max     step   default  label
+        { "wet",        "Wet",       0.0f,  100.0f, 1.0f,  50.0f,   "%" },
+        { "dry",        "Dry",       0.0f,  100.0f, 1.0f,   0.0f,   "%" },
+        { "carrier",    "Carrier",   0.0f,  2.0f,   1.0f,   0.0f,   "", carrierToText },
+        { "quality",    "Quality",   0.0f,  100.0f, 1.0f, 100.0f,   "%" },
+    };
+
+    // the first program is the original mda one, the others were added for this port
+    static constexpr mda::Program<kNumParameters> programs[] =
+    {
+        //  name                      wet    dry    carrier quality
+        { "Talkbox",                { 0.50f, 0.00f, 0.0f,   1.00f } },
+        { "Sidechain Talkbox",      { 0.50f, 0.00f, 1.0f,   1.00f } },
+        { "Robot Blend",            { 0.45f, 0.25f, 1.0f,   0.60f } },
+        { "Lo-Fi Formants",         { 0.55f, 0.00f, 1.0f,   0.15f } },
+    };
+
+    // everything update() derives from the parameters, as one immutable snapshot
+    struct Coefficients
+    {
+        float wet, dry;
+        int carrier; // CarrierSource
+        int order; // LPC order, from the quality and the sample rate
+    };
+};
+
+//==============================================================================
+/**
+*/
+class MdaTalkBoxAudioProcessor  : public mda::Processor<MdaTalkBoxAudioProcessor, MdaTalkBoxDescription>
+                            #if JucePlugin_Enable_ARA
+                             , public juce::AudioProcessorARAExtension
+                            #endif
+{
+public:
+    //==============================================================================
+    MdaTalkBoxAudioProcessor();
+    ~MdaTalkBoxAudioProcessor() override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+
+    void reset() override;
+
+private:
+    friend class mda::Processor<MdaTalkBoxAudioProcessor, MdaTalkBoxDescription>;
+
+    static constexpr int kMaxFrame = TalkBoxLpc::maxFrameSize;
+    static constexpr int kFrameStride = kMaxFrame + TalkBoxLpc::framePadding;
+
+    // two 50% overlapping frames of modulator and carrier, and the window, in
+    // one block allocated by prepareToPlay; the frames are analysed in place
+    mda::DspBuffer<float> frameBuffers;
+    float *buf0 = nullptr, *buf1 = nullptr, *car0 = nullptr, *car1 = nullptr, *window = nullptr;
+    TalkBoxLpc lpc;
+    int N = 1; // frame size, at half the sample rate
+    int O = 1; // LPC order
+
+    mda::RampedValue wetSmoother, drySmoother;
+    float wetRamp[kSubBlockSize], dryRamp[kSubBlockSize];
+    int carrier = MdaTalkBoxDescription::kCarrierRight;
+
+    // everything the sample loop carries from one block to the next
+    struct State
+    {
+        long pos = 0, K = 0;
+        float emphasis = 0.0f, FX = 0.0f;
+        float u0 = 0.0f, u1 = 0.0f, u2 = 0.0f, u3 = 0.0f, u4 = 0.0f; // output half-band filter
+        float d0 = 0.0f, d1 = 0.0f, d2 = 0.0f, d3 = 0.0f, d4 = 0.0f; // carrier half-band filter
+    };
+    State state;
+    float lastGain = 0.0f; // of the latest frame, for the meters
+
+    // mda::Processor hooks
+    void prepareResources(double sampleRate, int maximumBlockSize);
+    void prepareSmoothing(double sampleRate);
+    void pushMeters(int numSamples);
+    size_t dspHeapBytes() const noexcept { return frameBuffers.getHeapBytes() + lpc.getHeapBytes(); }
+    void saveDspState(mda::DspStateWriter& writer) const;
+    bool loadDspState(mda::DspStateReader& reader);
+    void update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const;
+    void applyCoefficients(const Coefficients& c, int rampSamples);
+
+    static int frameSizeFor(double sampleRate);
+    static int orderFor(double sampleRate, float quality);
+
+    template <typename SampleType, mda::ChannelLayout layout, bool hq>
+    void processChannels(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaTalkBoxAudioProcessor)
+};
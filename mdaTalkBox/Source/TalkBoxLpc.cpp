@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    TalkBoxLpc.cpp
+
+  ==============================================================================
+*/
+
+#include "TalkBoxLpc.h"
+
+//==============================================================================
+void TalkBoxLpc::prepare (int frameSize, int highestOrder)
+{
+    if (highestOrder <= fftOrderThreshold)
+    {
+        fft.reset();
+        fftBuffer.allocate (0);
+        return;
+    }
+
+    // long enough that the circular correlation doesn't wrap into the lags we use
+    auto fftOrder = juce::roundToInt (std::ceil (std::log2 ((double) (frameSize + highestOrder + 1))));
+    fft = std::make_unique<juce::dsp::FFT> (fftOrder);
+    fftBuffer.allocate (2 * (size_t) fft->getSize());
+}
+
+float TalkBoxLpc::process (float* frame, const float* carrier, int frameSize, int order, Method method) noexcept
+{
+    float r[maxOrder + 1], k[maxOrder + 1];
+
+    std::fill (frame + frameSize, frame + frameSize + framePadding, 0.0f);
+
+    auto useFft = fft != nullptr && (method == Method::fft || (method == Method::automatic && order > fftOrderThreshold));
+    if (useFft)
+        autocorrelateFft (frame, frameSize, order, r);
+    else
+        autocorrelate (frame, frameSize, order, r);
+
+    r[0] *= 1.001f; //stability fix
+
+    if (r[0] < 0.00001f)
+    {
+        juce::FloatVectorOperations::clear (frame, frameSize);
+        return 0.0f;
+    }
+
+    auto gain = levinsonDurbin (r, order, k);
+
+    for (int i = 1; i <= order; ++i)
+        k[i] = juce::jlimit (-0.995f, 0.995f, k[i]);
+
+    synthesise (frame, carrier, frameSize, order, gain, k);
+    return gain;
+}
+
+//==============================================================================
+// r[j] += frame[i] * frame[i + j] for all lags at once, so the inner loop is a
+// plain vector multiply-add instead of a dot product per lag
+void TalkBoxLpc::autocorrelate (const float* frame, int frameSize, int order, float* r) noexcept
+{
+    juce::FloatVectorOperations::clear (r, order + 1);
+
+    for (int i = 0; i < frameSize; ++i)
+        juce::FloatVectorOperations::addWithMultiply (r, frame + i, frame[i], order + 1);
+}
+
+// the inverse transform of the power spectrum, rescaled to the directly summed
+// energy so the gain doesn't depend on the FFT's normalisation
+void TalkBoxLpc::autocorrelateFft (const float* frame, int frameSize, int order, float* r) noexcept
+{
+    auto size = fft->getSize();
+    auto* data = fftBuffer.get();
+
+    juce::FloatVectorOperations::copy (data, frame, frameSize);
+    juce::FloatVectorOperations::clear (data + frameSize, 2 * size - frameSize);
+
+    fft->performRealOnlyForwardTransform (data, true);
+
+    for (int bin = 0; bin <= size / 2; ++bin)
+    {
+        auto re = data[2 * bin], im = data[2 * bin + 1];
+        data[2 * bin] = re * re + im * im;
+        data[2 * bin + 1] = 0.0f;
+    }
+
+    // mirrored for the backends that read the negative frequencies too
+    for (int bin = size / 2 + 1; bin < size; ++bin)
+    {
+        data[2 * bin] = data[2 * (size - bin)];
+        data[2 * bin + 1] = 0.0f;
+    }
+
+    fft->performRealOnlyInverseTransform (data);
+
+    auto energy = 0.0f;
+    for (int i = 0; i < frameSize; ++i)
+        energy += frame[i] * frame[i];
+
+    auto scale = data[0] > 0.0f ? energy / data[0] : 0.0f;
+    juce::FloatVectorOperations::multiply (r, data, scale, order + 1);
+}
+
+// in place: a[j] and a[i - j] are updated as a pair, so there's no copy of the
+// previous predictor
+float TalkBoxLpc::levinsonDurbin (const float* r, int order, float* k) noexcept
+{
+    float a[maxOrder + 1] {};
+    auto e = r[0];
+
+    for (int i = 1; i <= order; ++i)
+    {
+        if (std::abs (e) < 1.0e-20f)
+        {
+            std::fill (k + i, k + order + 1, 0.0f);
+            e = 0.0f;
+            break;
+        }
+
+        auto acc = -r[i];
+        for (int j = 1; j < i; ++j)
+            acc -= a[j] * r[i - j];
+
+        auto ki = acc / e;
+        k[i] = ki;
+
+        for (int j = 1, m = i - 1; j <= m; ++j, --m)
+        {
+            auto aj = a[j], am = a[m];
+            a[j] = aj + ki * am;
+            a[m] = am + ki * aj;
+        }
+        a[i] = ki;
+
+        e *= 1.0f - ki * ki;
+    }
+
+    return e < 1.0e-20f ? 0.0f : std::sqrt (e);
+}
+
+void TalkBoxLpc::synthesise (float* frame, const float* carrier, int frameSize, int order, float gain, const float* k) noexcept
+{
+    float z[maxOrder + 1] {};
+
+    for (int i = 0; i < frameSize; ++i)
+    {
+        auto x = gain * carrier[i];
+
+        for (int j = order; j > 0; --j) //lattice filter
+        {
+            x -= k[j] * z[j - 1];
+            z[j] = z[j - 1] + k[j] * x;
+        }
+
+        frame[i] = z[0] = x; //output will be windowed elsewhere
+    }
+}
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    TalkBoxLpc.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    The vocoder's analysis & synthesis of one frame: autocorrelation of the
+    windowed modulator, Levinson-Durbin for the reflection coefficients, then
+    the carrier through the all-pole lattice filter they describe, written
+    back over the frame.
+
+    Nothing allocates after prepare(). The autocorrelation runs across the
+    lags, one vector multiply-add per frame sample, or through an FFT for
+    high orders where that gets cheaper; mdaBenchmark --lpc measures both
+    per order.
+*/
+class TalkBoxLpc
+{
+public:
+    static constexpr int maxFrameSize = 1600;
+    static constexpr int maxOrder = 50;
+
+    // the frames must have this many samples of room after their end, the
+    // autocorrelation reads zeros there instead of checking the lags
+    static constexpr int framePadding = maxOrder + 1;
+
+    // orders above this use the FFT when it was prepared for, see mdaBenchmark --lpc
+    static constexpr int fftOrderThreshold = 32;
+
+    enum class Method { automatic, direct, fft };
+
+    /** Allocates the FFT work buffer if orders up to highestOrder would use it. */
+    void prepare (int frameSize, int highestOrder);
+
+    /** Replaces frame[0, frameSize) - the emphasised, windowed modulator - with
+        the carrier shaped by the modulator's spectral envelope. Returns the
+        prediction gain, 0 for a silent frame.
+    */
+    float process (float* frame, const float* carrier, int frameSize, int order, Method method = Method::automatic) noexcept;
+
+    size_t getHeapBytes() const noexcept    { return fftBuffer.getHeapBytes(); }
+
+    //==============================================================================
+    /** r[0, order] for the frame, which must have framePadding zeros after it. */
+    static void autocorrelate (const float* frame, int frameSize, int order, float* r) noexcept;
+    void autocorrelateFft (const float* frame, int frameSize, int order, float* r) noexcept;
+
+    /** Reflection coefficients k[1, order] from r[0, order], returns the gain. */
+    static float levinsonDurbin (const float* r, int order, float* k) noexcept;
+
+    static void synthesise (float* frame, const float* carrier, int frameSize, int order, float gain, const float* k) noexcept;
+
+private:
+    std::unique_ptr<juce::dsp::FFT> fft;
+    mda::DspBuffer<float> fftBuffer;
+};
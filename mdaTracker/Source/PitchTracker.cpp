@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+    PitchTracker.cpp
+
+  ==============================================================================
+*/
+
+#include "PitchTracker.h"
+
+//==============================================================================
+void PitchTracker::prepare (double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    // a window of at least fs / 48 for pitches down to about 45Hz: W is 1024
+    // at 44.1 & 48kHz, 2048 at 96kHz
+    auto fftOrder = juce::jmax (8, (int) std::ceil (std::log2 (sampleRate / 24.0)));
+    fft = std::make_unique<juce::dsp::FFT> (fftOrder);
+    frameSize = fft->getSize();
+    windowSize = frameSize / 2;
+
+    buffers.allocate (5 * (size_t) frameSize);
+    ring = buffers.get();
+    recent = ring + frameSize;
+    whole = recent + 2 * frameSize;
+    energy.allocate ((size_t) frameSize + 1);
+
+    reset();
+}
+
+void PitchTracker::reset() noexcept
+{
+    buffers.clear();
+    writePos = 0;
+    stage = 0;
+    countdown = hopSize / numStages;
+    frequency = 0.0f;
+    voiced = false;
+}
+
+void PitchTracker::setHopSize (int newHopSize) noexcept
+{
+    hopSize = juce::jlimit (numStages, maxHopSize, newHopSize);
+    countdown = juce::jmin (countdown, hopSize / numStages);
+}
+
+void PitchTracker::setMaximumFrequency (float hz) noexcept
+{
+    minLag = juce::jmax (2, (int) (sampleRate / juce::jmax (1.0f, hz)));
+}
+
+//==============================================================================
+void PitchTracker::push (const float* samples, int numSamples) noexcept
+{
+    while (numSamples > 0)
+    {
+        auto todo = juce::jmin (numSamples, countdown, frameSize - writePos);
+        juce::FloatVectorOperations::copy (ring + writePos, samples, todo);
+        writePos = (writePos + todo) & (frameSize - 1);
+        samples += todo;
+        numSamples -= todo;
+
+        if ((countdown -= todo) == 0)
+        {
+            runStage();
+            countdown = hopSize / numStages;
+        }
+    }
+}
+
+// one FFT at most per step; a frame below the gate is dropped and the next
+// step starts over with a fresh snapshot
+void PitchTracker::runStage() noexcept
+{
+    auto L = frameSize, W = windowSize;
+
+    switch (stage)
+    {
+        case 0:
+        {
+            // oldest sample first, with the running energy for the difference function
+            juce::FloatVectorOperations::copy (whole, ring + writePos, L - writePos);
+            juce::FloatVectorOperations::copy (whole + L - writePos, ring, writePos);
+            juce::FloatVectorOperations::clear (whole + L, L);
+
+            auto* e = energy.get();
+            e[0] = 0.0;
+            for (int i = 0; i < L; ++i)
+                e[i + 1] = e[i] + (double) whole[i] * whole[i];
+
+            if (e[L] - e[W] < (double) W * gateLevel * gateLevel)
+            {
+                voiced = false;
+                stage = 0;
+                return;
+            }
+
+            juce::FloatVectorOperations::copy (recent, whole + W, W);
+            juce::FloatVectorOperations::clear (recent + W, 2 * L - W);
+            fft->performRealOnlyForwardTransform (recent);
+            break;
+        }
+
+        case 1:
+            fft->performRealOnlyForwardTransform (whole);
+            break;
+
+        case 2:
+            // conj (recent) * whole: the correlation of the latest window with every earlier one
+            for (int bin = 0; bin < L; ++bin)
+            {
+                auto ar = recent[2 * bin], ai = recent[2 * bin + 1];
+                auto br = whole[2 * bin], bi = whole[2 * bin + 1];
+                recent[2 * bin]     = ar * br + ai * bi;
+                recent[2 * bin + 1] = ar * bi - ai * br;
+            }
+            fft->performRealOnlyInverseTransform (recent);
+            break;
+
+        default:
+            searchPeriod();
+            break;
+    }
+
+    stage = (stage + 1) % numStages;
+}
+
+// the cumulative mean normalised difference d'(tau) goes in whole[], which is
+// free again; the first dip under the threshold, walked down to its minimum,
+// then refined with a parabola through its neighbours
+void PitchTracker::searchPeriod() noexcept
+{
+    auto W = windowSize;
+    auto* e = energy.get();
+    auto* dn = whole;
+
+    // lag 0 is the window's own energy, which sets the FFT's scale
+    auto latest = e[2 * W] - e[W];
+    auto scale = recent[W] > 0.0f ? latest / recent[W] : 0.0;
+
+    double sum = 0.0;
+    dn[0] = 1.0f;
+    for (int tau = 1; tau < W; ++tau)
+    {
+        auto earlier = e[2 * W - tau] - e[W - tau];
+        auto d = juce::jmax (0.0, latest + earlier - 2.0 * scale * recent[W - tau]);
+        sum += d;
+        dn[tau] = sum > 0.0 ? (float) (d * tau / sum) : 1.0f;
+    }
+
+    for (int tau = minLag; tau < W - 1; ++tau)
+    {
+        if (dn[tau] >= yinThreshold)
+            continue;
+
+        while (tau + 1 < W - 1 && dn[tau + 1] < dn[tau])
+            ++tau;
+
+        auto a = dn[tau - 1], b = dn[tau], c = dn[tau + 1];
+        auto curve = a - 2.0f * b + c;
+        auto period = (float) tau + (curve > 0.0f ? 0.5f * (a - c) / curve : 0.0f);
+
+        frequency = (float) (sampleRate / period);
+        voiced = true;
+        return;
+    }
+
+    voiced = false;
+}
+
+//==============================================================================
+void PitchTracker::save (mda::DspStateWriter& writer) const
+{
+    writer.writeSamples (ring, (size_t) frameSize);
+    writer.write (writePos);
+    writer.write (frequency);
+    writer.write (voiced ? 1 : 0);
+}
+
+bool PitchTracker::load (mda::DspStateReader& reader)
+{
+    int pos = 0, isVoiced = 0;
+    float hz = 0.0f;
+    auto ok = reader.readSamples (ring, (size_t) frameSize)
+           && reader.read (pos) && reader.read (hz) && reader.read (isVoiced)
+           && pos >= 0 && pos < frameSize;
+
+    if (! ok)
+        return false;
+
+    writePos = pos;
+    frequency = hz;
+    voiced = isVoiced != 0;
+    stage = 0;
+    countdown = hopSize / numStages;
+    return true;
+}
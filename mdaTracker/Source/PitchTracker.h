@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    PitchTracker.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+    YIN pitch detector with the difference function taken from an FFT
+    cross-correlation, over work buffers allocated once by prepare().
+
+    The most recent window of W samples is compared with the W samples
+    starting every lag up to W earlier. An analysis starts every hop samples
+    and is split into numStages steps, one every hop / numStages samples:
+    snapshot & first FFT, second FFT, spectrum product & inverse FFT, then
+    the normalised difference and the period search. No block does more than
+    one FFT, however short the host's blocks are.
+*/
+class PitchTracker
+{
+public:
+    static constexpr int numStages = 4;
+    static constexpr int maxHopSize = 512;
+    static constexpr float yinThreshold = 0.15f;
+
+    /** Allocates the buffers, the window grows with the rate so the lowest pitch stays around 45Hz. */
+    void prepare (double sampleRate);
+    void reset() noexcept;
+
+    void setHopSize (int newHopSize) noexcept;
+    void setMaximumFrequency (float hz) noexcept;
+    void setGate (float rmsLevel) noexcept      { gateLevel = rmsLevel; }
+
+    /** Adds samples, running the analysis steps that fall due. */
+    void push (const float* samples, int numSamples) noexcept;
+
+    /** The last voiced frame's pitch in Hz, 0 before the first one. */
+    float getFrequency() const noexcept         { return frequency; }
+    bool isVoiced() const noexcept              { return voiced; }
+
+    /** From a sample going in to the pitch found around it: half a window plus a hop. */
+    int getLatencySamples() const noexcept      { return windowSize / 2 + hopSize; }
+    int getMaximumLatencySamples() const noexcept { return windowSize / 2 + maxHopSize; }
+
+    size_t getHeapBytes() const noexcept        { return buffers.getHeapBytes() + energy.getHeapBytes(); }
+
+    /** The input history, frequency and voicing, for the DSP state; an analysis
+        in progress starts over.
+    */
+    void save (mda::DspStateWriter& writer) const;
+    bool load (mda::DspStateReader& reader);
+
+private:
+    void runStage() noexcept;
+    void searchPeriod() noexcept;
+
+    double sampleRate = 44100.0;
+    int frameSize = 0, windowSize = 0; // L = 2W, the FFT size
+    int hopSize = 256, minLag = 2;
+    float gateLevel = 0.0f;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    mda::DspBuffer<float> buffers; // ring, then two 2L FFT buffers
+    mda::DspBuffer<double> energy; // prefix sums of the squared snapshot
+    float *ring = nullptr, *recent = nullptr, *whole = nullptr;
+    int writePos = 0, countdown = 0, stage = 0;
+
+    float frequency = 0.0f;
+    bool voiced = false;
+};
@@ -0,0 +1,17 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaTrackerAudioProcessorEditor::MdaTrackerAudioProcessorEditor (MdaTrackerAudioProcessor& p)
+    : ProcessorEditor (p, { { "Pitch Hz", mda::BarMeter::Scale::linear, 0.0f, 2000.0f },
+                            { "Envelope", mda::BarMeter::Scale::decibels, -60.0f, 6.0f } })
+{
+}
@@ -0,0 +1,26 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    The generic layout: one row per parameter, the level meters, then the
+    oscillator's frequency and the input envelope it follows.
+*/
+class MdaTrackerAudioProcessorEditor  : public mda::ProcessorEditor<MdaTrackerAudioProcessor>
+{
+public:
+    explicit MdaTrackerAudioProcessorEditor (MdaTrackerAudioProcessor&);
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaTrackerAudioProcessorEditor)
+};
@@ -0,0 +1,279 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+MdaTrackerAudioProcessor::MdaTrackerAudioProcessor()
+{
+    reset();
+}
+
+MdaTrackerAudioProcessor::~MdaTrackerAudioProcessor()
+{
+}
+
+//==============================================================================
+void MdaTrackerAudioProcessor::prepareResources (double newSampleRate, int)
+{
+    sampleRate = (float)newSampleRate;
+    tracker.prepare(newSampleRate);
+
+    // fixed for any hop size, the window depends on the rate
+    latency = tracker.getMaximumLatencySamples();
+    reportLatency(latency);
+
+    auto size = juce::nextPowerOfTwo(latency + 1);
+    delayBuffer.allocate(2 * (size_t)size);
+    delayLines[0] = delayBuffer.get();
+    delayLines[1] = delayLines[0] + size;
+    delayMask = size - 1;
+}
+
+void MdaTrackerAudioProcessor::prepareSmoothing (double newSampleRate)
+{
+    for (auto* smoother : { &drySmoother, &wetSmoother, &dynSmoother }) {
+        smoother->reset(newSampleRate, kSmoothingTime);
+    }
+}
+
+void MdaTrackerAudioProcessor::reset()
+{
+    tracker.reset();
+    delayBuffer.clear();
+    state = {};
+}
+
+// the live state for the optional snapshot in the saved state, in a fixed order
+void MdaTrackerAudioProcessor::saveDspState (mda::DspStateWriter& writer) const
+{
+    auto& st = state;
+    tracker.save(writer);
+    writer.writeSamples(delayBuffer.get(), delayBuffer.getSize());
+    writer.write(st.writePos);
+    for (auto v : { st.env, st.phase, st.increment, st.low[0], st.low[1], st.band[0], st.band[1] }) {
+        writer.write(v);
+    }
+}
+
+bool MdaTrackerAudioProcessor::loadDspState (mda::DspStateReader& reader)
+{
+    State st;
+    auto ok = tracker.load(reader)
+           && reader.readSamples(delayBuffer.get(), delayBuffer.getSize())
+           && reader.read(st.writePos) && st.writePos >= 0 && st.writePos <= delayMask;
+    for (auto* v : { &st.env, &st.phase, &st.increment, &st.low[0], &st.low[1], &st.band[0], &st.band[1] }) {
+        ok = ok && reader.read(*v);
+    }
+
+    if (! ok)
+        return false;
+
+    state = st;
+    return true;
+}
+
+// recalculate the coefficients depending on the changed parameters,
+// called off the audio thread
+void MdaTrackerAudioProcessor::update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const {
+    c.mode = juce::roundToInt(parameters[kMode].convertFrom0to1(values[kMode]));
+
+    auto mix = values[kMix];
+    auto dynamics = values[kDynamics];
+    auto gain = juce::Decibels::decibelsToGain(parameters[kOutput].convertFrom0to1(values[kOutput]));
+
+    if (c.mode == kEq) {
+        // up to +12dB at the fundamental, over the untouched input
+        c.dry = gain;
+        c.wet = 3.0f * mix * gain;
+        c.dynamics = 0.0f;
+    } else if (c.mode == kRing) {
+        c.dry = gain * std::sqrt(1.0f - mix);
+        c.wet = gain * mix;
+        c.dynamics = 0.0f;
+    } else {
+        // the oscillator at a fixed level or following the input's envelope
+        c.dry = gain * std::sqrt(1.0f - mix);
+        c.wet = 0.3f * gain * mix * (1.0f - dynamics);
+        c.dynamics = 0.6f * gain * mix * dynamics;
+    }
+
+    c.transpose = std::exp2(parameters[kTranspose].convertFrom0to1(values[kTranspose]) / 12.0f);
+    c.maximumHz = maximumToHz(parameters[kMaximum].convertFrom0to1(values[kMaximum]));
+    c.trigger = juce::Decibels::decibelsToGain(parameters[kTrigger].convertFrom0to1(values[kTrigger]));
+
+    // up to a quarter second time constant
+    auto seconds = 0.25f * values[kGlide] * values[kGlide];
+    c.glide = seconds > 0.0f ? 1.0f - std::exp(-1.0f / (seconds * fs)) : 1.0f;
+
+    c.release = std::pow(10.0f, -10.0f / fs);
+    c.hopSize = 64 << juce::roundToInt(parameters[kHop].convertFrom0to1(values[kHop]));
+}
+
+// audio thread: start ramping towards a new snapshot, over the usual
+// smoothing time unless rampSamples is given
+void MdaTrackerAudioProcessor::applyCoefficients(const Coefficients& c, int rampSamples) {
+    if (rampSamples < 0) {
+        drySmoother.setTargetValue(c.dry);
+        wetSmoother.setTargetValue(c.wet);
+        dynSmoother.setTargetValue(c.dynamics);
+    } else {
+        drySmoother.setTargetValue(c.dry, rampSamples);
+        wetSmoother.setTargetValue(c.wet, rampSamples);
+        dynSmoother.setTargetValue(c.dynamics, rampSamples);
+    }
+    mode = c.mode;
+    transpose = c.transpose;
+    glide = c.glide;
+    release = c.release;
+
+    tracker.setMaximumFrequency(c.maximumHz);
+    tracker.setGate(c.trigger);
+    tracker.setHopSize(c.hopSize);
+}
+
+// the oscillator's frequency & the input envelope for the editor
+void MdaTrackerAudioProcessor::pushMeters (int numSamples)
+{
+    meters.push(numSamples, state.increment * sampleRate, state.env);
+}
+
+// the tracker takes the live input a sub-block at a time, spreading its
+// analysis over the hop; everything heard comes from the delayed input
+template <typename SampleType, mda::ChannelLayout layout, bool hq>
+void MdaTrackerAudioProcessor::processChannels (juce::AudioBuffer<SampleType>& buffer, int numSamples)
+{
+    constexpr bool stereoIn = layout == mda::ChannelLayout::stereo;
+    constexpr bool stereoOut = layout != mda::ChannelLayout::mono;
+
+    auto* in1 = buffer.getReadPointer(0);
+    auto* in2 = stereoIn ? buffer.getReadPointer(1) : in1;
+    auto* out1 = buffer.getWritePointer(0);
+    auto* out2 = stereoOut ? buffer.getWritePointer(1) : nullptr;
+
+    auto st = state;
+    auto* line1 = delayLines[0];
+    auto* line2 = delayLines[1];
+    auto mask = delayMask;
+    float a, b, m, t, osc, oa, ob;
+
+    for (auto start = 0; start < numSamples; start += kSubBlockSize)
+    {
+        auto todo = juce::jmin(kSubBlockSize, numSamples - start);
+
+        for (auto j = 0; j < todo; j++) {
+            auto i = start + j;
+            mono[j] = stereoIn ? 0.5f * (float)(in1[i] + in2[i]) : (float)in1[i];
+        }
+        tracker.push(mono, todo);
+
+        // hold the last pitch through unvoiced frames; nothing sounds before the first
+        auto hz = tracker.getFrequency();
+        auto target = hz > 0.0f ? juce::jmin(0.45f, hz * transpose / sampleRate) : st.increment;
+        auto level = (hz > 0.0f || st.increment > 0.0f) ? 1.0f : 0.0f;
+
+        drySmoother.render(dryRamp, todo);
+        wetSmoother.render(wetRamp, todo);
+        dynSmoother.render(dynRamp, todo);
+
+        // the EQ's band pass is retuned once per sub-block, at Q = 5
+        auto f = 2.0f * std::sin(juce::MathConstants<float>::pi * juce::jmin(st.increment, 0.16f));
+        const float q = 0.2f;
+
+        for (auto j = 0; j < todo; j++)
+        {
+            auto i = start + j;
+            line1[st.writePos] = (float)in1[i];
+            if constexpr (stereoIn) {
+                line2[st.writePos] = (float)in2[i];
+            }
+            auto r = (st.writePos - latency) & mask;
+            a = line1[r];
+            b = stereoIn ? line2[r] : a;
+            st.writePos = (st.writePos + 1) & mask;
+
+            m = stereoIn ? 0.5f * (a + b) : a;
+            t = std::abs(m); //dynamics envelope
+            st.env = (t > st.env) ? 0.5f * (t + st.env) : st.env * release;
+
+            st.increment += glide * (target - st.increment);
+            st.phase += st.increment;
+            if (st.phase >= 1.0f) st.phase -= 1.0f;
+
+            switch (mode)
+            {
+                case kRing:
+                    osc = wetRamp[j] * std::sin(juce::MathConstants<float>::twoPi * st.phase);
+                    oa = dryRamp[j] * a + osc * a;
+                    ob = dryRamp[j] * b + osc * b;
+                    break;
+
+                case kEq:
+                    st.low[0] += f * st.band[0];
+                    st.band[0] += f * (a - st.low[0] - q * st.band[0]);
+                    oa = dryRamp[j] * a + wetRamp[j] * q * st.band[0];
+                    if constexpr (stereoIn) {
+                        st.low[1] += f * st.band[1];
+                        st.band[1] += f * (b - st.low[1] - q * st.band[1]);
+                        ob = dryRamp[j] * b + wetRamp[j] * q * st.band[1];
+                    } else {
+                        ob = oa;
+                    }
+                    break;
+
+                default:
+                    if (mode == kSine) {
+                        osc = std::sin(juce::MathConstants<float>::twoPi * st.phase);
+                    } else if (mode == kSquare) {
+                        osc = st.phase < 0.5f ? 0.5f : -0.5f;
+                    } else {
+                        osc = st.phase - 0.5f; //saw
+                    }
+                    osc *= level * (wetRamp[j] + dynRamp[j] * st.env);
+                    oa = dryRamp[j] * a + osc;
+                    ob = dryRamp[j] * b + osc;
+                    break;
+            }
+
+#ifdef DEBUG
+            mda::checkSample(oa);
+            mda::checkSample(ob);
+#endif
+            out1[i] = (SampleType)oa;
+            if constexpr (stereoOut) {
+                out2[i] = (SampleType)ob;
+            }
+        }
+    }
+
+    //anti-denormal
+    auto flush = [](float v) { return std::abs(v) < 1.0e-10f ? 0.0f : v; };
+    st.env = flush(st.env);
+    for (int ch = 0; ch < 2; ++ch) {
+        st.low[ch] = flush(st.low[ch]);
+        st.band[ch] = flush(st.band[ch]);
+    }
+    state = st;
+}
+
+//==============================================================================
+juce::AudioProcessorEditor* MdaTrackerAudioProcessor::createEditor()
+{
+    return new MdaTrackerAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+// (left out when the processors are built into a host such as mdaBenchmark)
+#if ! MDA_EMBEDDED_PLUGINS
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new MdaTrackerAudioProcessor();
+}
+#endif
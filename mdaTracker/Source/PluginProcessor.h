@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PitchTracker.h"
+
+//==============================================================================
+// compile-time description of the plugin, see mda::Processor
+struct MdaTrackerDescription
+{
+    static constexpr const char* name = "mdaTracker";
+    static constexpr const char* stateTag = "mdTr"; // identifies our binary state
+
+    // parameter indices, in the order of the table below
+    enum ParameterIndex
+    {
+        kMode, kDynamics, kMix, kGlide, kTranspose, kMaximum, kTrigger, kOutput, kHop,
+        kNumParameters
+    };
+
+    // oscillators that follow the pitch, a ring modulator, or a band pass on the fundamental
+    enum Mode { kSine, kSquare, kSaw, kRing, kEq };
+
+    static juce::String modeToText(float value, int)
+    {
+        switch (juce::roundToInt(value)) {
+            case kSine:   return "Sine";
+            case kSquare: return "Square";
+            case kSaw:    return "Saw";
+            case kRing:   return "Ring Mod";
+            default:      return "EQ";
+        }
+    }
+
+    // the highest pitch followed, 40Hz to 6.3kHz as in the original
+    static float maximumToHz(float percent)
+    {
+        return std::pow(10.0f, 1.6f + 0.022f * percent);
+    }
+
+    static juce::String maximumToText(float value, int)
+    {
+        return juce::String(juce::roundToInt(maximumToHz(value))) + " Hz";
+    }
+
+    static juce::String hopToText(float value, int)
+    {
+        return juce::String(64 << juce::roundToInt(value));
+    }
+
+    static constexpr mda::ParameterSpec parameters[] =
+    {
+        //  id          name          min      max     step   default  label
+        { "mode",       "Mode",        0.0f,    4.0f,  1.0f,   0.0f,   "", modeToText },
+        { "dynamics",   "Dynamics",    0.0f,  100.0f,  1.0f, 100.0f,   "%" },
+        { "mix",        "Mix",         0.0f,  100.0f,  1.0f, 100.0f,   "%" },
+        { "glide",      "Glide",       0.0f,  100.0f,  1.0f,  50.0f,   "%" },
+        { "transpose",  "Transpose", -36.0f,   36.0f,  1.0f,   0.0f,   "semi" },
+        { "maximum",    "Maximum",     0.0f,  100.0f,  1.0f,  80.0f,   "", maximumToText },
+        { "trigger",    "Trigger",   -60.0f,    0.0f,  1.0f, -30.0f,   "dB" },
+        { "output",     "Output",    -20.0f,   20.0f,  0.1f,   0.0f,   "dB" },
+        // how often the pitch is measured, in samples
+        { "hop",        "Hop Size",    0.0f,    3.0f,  1.0f,   2.0f,   "samples", hopToText },
+    };
+
+    // the first program is the original mda one, the others were added for this port
+    static constexpr mda::Program<kNumParameters> programs[] =
+    {
+        //  name                      mode   dynamics mix   glide  transp max    trigger output hop
+        { "Pitch Tracker",          { 0.00f, 1.00f, 1.00f, 0.50f, 0.500f, 0.80f, 0.50f, 0.50f, 0.667f } },
+        { "Octave Down Square",     { 0.25f, 1.00f, 0.60f, 0.30f, 0.333f, 0.60f, 0.50f, 0.50f, 0.667f } },
+        { "Ring Tracker",           { 0.75f, 1.00f, 0.70f, 0.20f, 0.500f, 0.80f, 0.45f, 0.50f, 0.333f } },
+        { "Fundamental EQ",         { 1.00f, 0.00f, 0.50f, 0.50f, 0.500f, 0.80f, 0.50f, 0.50f, 0.667f } },
+        { "Fast Lead Saw",          { 0.50f, 1.00f, 1.00f, 0.05f, 0.500f, 0.90f, 0.55f, 0.50f, 0.000f } },
+    };
+
+    // everything update() derives from the parameters, as one immutable snapshot
+    struct Coefficients
+    {
+        int mode; // Mode
+        float dry, wet, dynamics; // levels, dynamics scales the input envelope
+        float transpose; // frequency ratio
+        float maximumHz, trigger; // tracker range & gate
+        float glide; // one pole coefficient towards the tracked pitch
+        float release; // envelope follower
+        int hopSize;
+    };
+};
+
+//==============================================================================
+/**
+*/
+class MdaTrackerAudioProcessor  : public mda::Processor<MdaTrackerAudioProcessor, MdaTrackerDescription>
+                            #if JucePlugin_Enable_ARA
+                             , public juce::AudioProcessorARAExtension
+                            #endif
+{
+public:
+    //==============================================================================
+    MdaTrackerAudioProcessor();
+    ~MdaTrackerAudioProcessor() override;
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+
+    void reset() override;
+
+private:
+    friend class mda::Processor<MdaTrackerAudioProcessor, MdaTrackerDescription>;
+
+    PitchTracker tracker;
+    float sampleRate = 44100.0f;
+
+    // the input is delayed by the tracker's latency at the longest hop, so the
+    // delay and the reported latency never move when the hop does; one power
+    // of two ring per channel in a single allocation
+    mda::DspBuffer<float> delayBuffer;
+    float* delayLines[2] = { nullptr, nullptr };
+    int delayMask = 0, latency = 0; // latency is also the delay
+
+    mda::RampedValue drySmoother, wetSmoother, dynSmoother;
+    float dryRamp[kSubBlockSize], wetRamp[kSubBlockSize], dynRamp[kSubBlockSize];
+    float mono[kSubBlockSize];
+    int mode = MdaTrackerDescription::kSine;
+    float transpose = 1.0f, glide = 1.0f, release = 0.0f;
+
+    // everything the sample loop carries from one block to the next
+    struct State
+    {
+        int writePos = 0;
+        float env = 0.0f; // input envelope
+        float phase = 0.0f, increment = 0.0f; // oscillator, in cycles
+        float low[2] = {}, band[2] = {}; // EQ mode state variable filters
+    };
+    State state;
+
+    // mda::Processor hooks
+    void prepareResources(double sampleRate, int maximumBlockSize);
+    void prepareSmoothing(double sampleRate);
+    void pushMeters(int numSamples);
+    size_t dspHeapBytes() const noexcept { return tracker.getHeapBytes() + delayBuffer.getHeapBytes(); }
+    void saveDspState(mda::DspStateWriter& writer) const;
+    bool loadDspState(mda::DspStateReader& reader);
+    void update(Coefficients& c, juce::uint32 changed, float fs, const float* values) const;
+    void applyCoefficients(const Coefficients& c, int rampSamples);
+
+    template <typename SampleType, mda::ChannelLayout layout, bool hq>
+    void processChannels(juce::AudioBuffer<SampleType>& buffer, int numSamples);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MdaTrackerAudioProcessor)
+};
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    mda_BiquadCascade.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    One biquad section, normalised so a0 is 1. The designs are the usual
+    cookbook ones and run on the coefficient thread, not per sample.
+*/
+struct BiquadCoefficients
+{
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+
+    static BiquadCoefficients lowPass (double sampleRate, double hz, double q)
+    {
+        auto [alpha, cosw] = prewarp (sampleRate, hz, q);
+        return normalise ((1.0 - cosw) / 2.0, 1.0 - cosw, (1.0 - cosw) / 2.0, 1.0 + alpha, -2.0 * cosw, 1.0 - alpha);
+    }
+
+    static BiquadCoefficients highPass (double sampleRate, double hz, double q)
+    {
+        auto [alpha, cosw] = prewarp (sampleRate, hz, q);
+        return normalise ((1.0 + cosw) / 2.0, -(1.0 + cosw), (1.0 + cosw) / 2.0, 1.0 + alpha, -2.0 * cosw, 1.0 - alpha);
+    }
+
+    static BiquadCoefficients bandPass (double sampleRate, double hz, double q)
+    {
+        auto [alpha, cosw] = prewarp (sampleRate, hz, q);
+        return normalise (alpha, 0.0, -alpha, 1.0 + alpha, -2.0 * cosw, 1.0 - alpha);
+    }
+
+    /** gain is linear, above 1 for a peak and below for a dip */
+    static BiquadCoefficients peak (double sampleRate, double hz, double q, double gain)
+    {
+        auto [alpha, cosw] = prewarp (sampleRate, hz, q);
+        auto a = std::sqrt (juce::jmax (1.0e-4, gain));
+        return normalise (1.0 + alpha * a, -2.0 * cosw, 1.0 - alpha * a, 1.0 + alpha / a, -2.0 * cosw, 1.0 - alpha / a);
+    }
+
+private:
+    // alpha & cos w0, kept clear of dc & nyquist where the designs fall apart
+    static std::pair<double, double> prewarp (double sampleRate, double hz, double q)
+    {
+        auto w = juce::MathConstants<double>::twoPi * juce::jlimit (1.0, 0.49 * sampleRate, hz) / sampleRate;
+        return { std::sin (w) / (2.0 * q), std::cos (w) };
+    }
+
+    static BiquadCoefficients normalise (double b0, double b1, double b2, double a0, double a1, double a2)
+    {
+        return { (float) (b0 / a0), (float) (b1 / a0), (float) (b2 / a0), (float) (a1 / a0), (float) (a2 / a0) };
+    }
+};
+
+//==============================================================================
+/**
+    Up to maxStages biquads in series, run on both channels at once: each stage
+    updates the left & right states with the same coefficients, side by side
+    in memory, so the compiler keeps a sample frame in one register. A mono
+    signal uses the left lane only.
+
+    Transposed direct form II, with the states in float like the coefficients.
+*/
+template <int maxStages>
+class StereoBiquadCascade
+{
+public:
+    void setStages (const BiquadCoefficients* newStages, int numNewStages) noexcept
+    {
+        jassert (numNewStages <= maxStages);
+        numStages = juce::jmin (numNewStages, maxStages);
+        std::copy (newStages, newStages + numStages, stages.begin());
+    }
+
+    void reset() noexcept
+    {
+        for (auto& s : states)
+            s = {};
+    }
+
+    /** Starts the right lane from where the left one is, e.g. when it rejoins after a mono section. */
+    void copyLeftToRight() noexcept
+    {
+        for (auto& s : states)
+        {
+            s.s[1] = s.s[0];
+            s.s[3] = s.s[2];
+        }
+    }
+
+    /** right may be nullptr, left is then processed on its own. */
+    template <typename SampleType>
+    void process (SampleType* left, SampleType* right, int numSamples) noexcept
+    {
+        if (right != nullptr)
+            processLanes<SampleType, 2> (left, right, numSamples);
+        else
+            processLanes<SampleType, 1> (left, left, numSamples);
+    }
+
+    int getNumStages() const noexcept       { return numStages; }
+
+    /** All the filter states, s1 left & right then s2 left & right per stage, for saving. */
+    float* getStateData() noexcept                      { return states[0].s; }
+    const float* getStateData() const noexcept          { return states[0].s; }
+    static constexpr size_t numStateValues = 4 * (size_t) maxStages;
+
+private:
+    struct alignas (16) State
+    {
+        float s[4] {}; // s1 l, s1 r, s2 l, s2 r
+    };
+    static_assert (sizeof (State) == 4 * sizeof (float), "states must be contiguous");
+
+    template <typename SampleType, int numLanes>
+    void processLanes (SampleType* left, SampleType* right, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float x[2] = { (float) left[i], (float) right[i] };
+
+            for (int n = 0; n < numStages; ++n)
+            {
+                auto& c = stages[(size_t) n];
+                auto* s = states[(size_t) n].s;
+
+                for (int lane = 0; lane < numLanes; ++lane)
+                {
+                    auto y = c.b0 * x[lane] + s[lane];
+                    s[lane] = c.b1 * x[lane] - c.a1 * y + s[2 + lane];
+                    s[2 + lane] = c.b2 * x[lane] - c.a2 * y;
+                    x[lane] = y;
+                }
+            }
+
+            left[i] = (SampleType) x[0];
+            if constexpr (numLanes == 2)
+                right[i] = (SampleType) x[1];
+        }
+    }
+
+    std::array<BiquadCoefficients, (size_t) maxStages> stages {};
+    std::array<State, (size_t) maxStages> states {};
+    int numStages = 0;
+};
+
+} // namespace mda
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    mda_DspBuffer.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    Heap storage for a delay line or similar DSP buffer.
+
+    Plugins allocate these from prepareToPlay, never from the constructor, so a
+    host scanning plugins or loading a session only pays for the processor
+    object and its parameters. The buffer knows its size, which is what
+    Processor::getHeapBytes() adds up.
+*/
+template <typename Type>
+class DspBuffer
+{
+public:
+    DspBuffer() = default;
+
+    /** Resizes the buffer if needed and clears it. Call from prepareToPlay. */
+    void allocate (size_t numElements)
+    {
+        if (numElements != size)
+        {
+            data.free();
+            data.malloc (numElements);
+            size = numElements;
+        }
+
+        clear();
+    }
+
+    void free() noexcept
+    {
+        data.free();
+        size = 0;
+    }
+
+    /** Safe to call before allocate(), e.g. from a reset() in the constructor. */
+    void clear() noexcept
+    {
+        if (size > 0)
+            data.clear (size);
+    }
+
+    Type* get() const noexcept                  { return data.get(); }
+    size_t getSize() const noexcept             { return size; }
+    size_t getHeapBytes() const noexcept        { return size * sizeof (Type); }
+
+private:
+    juce::HeapBlock<Type> data;
+    size_t size = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (DspBuffer)
+};
+
+} // namespace mda
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    mda_MappingTable.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    Linearly interpolated lookup table for the exp/pow parameter mappings.
+
+    Inputs outside the table range are clamped. In debug builds initialise()
+    measures the worst-case relative error of the table against the exact
+    function and asserts that it stays below maxRelativeError.
+*/
+class MappingTable
+{
+public:
+    static constexpr double maxRelativeError = 1.0e-4;
+
+    MappingTable() = default;
+
+    MappingTable (const std::function<float (float)>& exactFunction,
+                  float minInput, float maxInput, size_t numPoints)
+    {
+        initialise (exactFunction, minInput, maxInput, numPoints);
+    }
+
+    void initialise (const std::function<float (float)>& exactFunction,
+                     float minInput, float maxInput, size_t numPoints)
+    {
+        jassert (juce::dsp::LookupTableTransform<float>::calculateMaxRelativeError (exactFunction, minInput, maxInput,
+                                                                                    numPoints) < maxRelativeError);
+        table.initialise (exactFunction, minInput, maxInput, numPoints);
+        tableSize = numPoints + 1; // LookupTable adds a guard point
+    }
+
+    float operator() (float input) const noexcept   { return table.processSample (input); }
+
+    /** Size of the table data, for Processor::getHeapBytes(). */
+    size_t getHeapBytes() const noexcept            { return tableSize * sizeof (float); }
+
+private:
+    juce::dsp::LookupTableTransform<float> table;
+    size_t tableSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (MappingTable)
+};
+
+//==============================================================================
+/** Gain for the -24..+6 dB output level parameters, from a table shared by all instances. */
+inline float outputLevelToGain (float decibels) noexcept
+{
+    static const MappingTable table { [] (float dB) { return juce::Decibels::decibelsToGain (dB); },
+                                      -24.0f, 6.0f, 256 };
+    return table (decibels);
+}
+
+} // namespace mda
@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+    mda_OscillatorBank.cpp
+
+  ==============================================================================
+*/
+
+namespace mda
+{
+
+//==============================================================================
+BandLimitedWavetable::BandLimitedWavetable (const std::function<float (int)>& amplitude)
+    : data ((size_t) numTables * (tableSize + 1))
+{
+    // every harmonic is read from one sine cycle, (n * h) wraps exactly
+    std::vector<double> sine ((size_t) tableSize), sum ((size_t) tableSize, 0.0);
+    for (int n = 0; n < tableSize; ++n)
+        sine[(size_t) n] = std::sin (juce::MathConstants<double>::twoPi * n / tableSize);
+
+    // each table adds the next octave of harmonics to the one before
+    auto harmonic = 1;
+    for (int k = 0; k < numTables; ++k)
+    {
+        for (; harmonic <= (1 << k); ++harmonic)
+        {
+            auto a = (double) amplitude (harmonic);
+            if (a == 0.0)
+                continue;
+
+            for (int n = 0; n < tableSize; ++n)
+                sum[(size_t) n] += a * sine[(size_t) ((n * harmonic) & (tableSize - 1))];
+        }
+
+        auto* table = data.data() + (size_t) k * (tableSize + 1);
+        for (int n = 0; n < tableSize; ++n)
+            table[n] = (float) sum[(size_t) n];
+        table[tableSize] = table[0];
+    }
+
+    auto range = juce::FloatVectorOperations::findMinAndMax (getTable (numTables - 1), tableSize);
+    auto peak = juce::jmax (-range.getStart(), range.getEnd());
+    if (peak > 0.0f)
+        juce::FloatVectorOperations::multiply (data.data(), 1.0f / peak, (int) data.size());
+}
+
+//==============================================================================
+OscillatorBank::OscillatorBank() noexcept
+{
+    std::fill (std::begin (lowerTables), std::end (lowerTables), silence);
+    std::fill (std::begin (upperTables), std::end (upperTables), silence);
+}
+
+void OscillatorBank::setNumPartials (int newNumPartials) noexcept
+{
+    jassert (newNumPartials >= 0 && newNumPartials <= maxPartials);
+    numPartials = juce::jlimit (0, maxPartials, newNumPartials);
+
+    // dropped partials fade out over the next render() before their lanes stop
+    for (int p = numPartials; p < maxPartials; ++p)
+        targets[p] = 0.0f;
+
+    numLanes = juce::jmax (numLanes, roundUpToLanes (numPartials));
+}
+
+void OscillatorBank::setPartial (int index, const BandLimitedWavetable& waveform, float cyclesPerSample, float amplitude) noexcept
+{
+    jassert (index >= 0 && index < numPartials);
+
+    // faded out over the octave below nyquist, so a partial sweeping up through
+    // it is never cut off at a render() boundary
+    auto octavesBelowNyquist = std::log2 (0.5f / juce::jmax (cyclesPerSample, 1.0e-9f));
+    targets[index] = amplitude * juce::jlimit (0.0f, 1.0f, octavesBelowNyquist);
+
+    cyclesPerSample = juce::jlimit (0.0f, 0.5f, cyclesPerSample);
+    increments[index] = (juce::uint32) (juce::int64) (cyclesPerSample * 4294967296.0);
+
+    auto position = BandLimitedWavetable::getTablePosition (cyclesPerSample);
+    auto lower = (int) position;
+    lowerTables[index] = waveform.getTable (lower);
+    upperTables[index] = waveform.getTable (juce::jmin (lower + 1, BandLimitedWavetable::numTables - 1));
+    blends[index] = position - (float) lower;
+}
+
+void OscillatorBank::render (float* dest, int numSamples) noexcept
+{
+    constexpr int fractionBits = 32 - BandLimitedWavetable::tableBits;
+    constexpr juce::uint32 fractionMask = (1u << fractionBits) - 1;
+    constexpr float fractionScale = 1.0f / (float) (1u << fractionBits);
+
+    // worked on in locals, which dest can't alias, so they stay in registers
+    alignas (16) juce::uint32 phase[maxPartials], increment[maxPartials];
+    alignas (16) float amplitude[maxPartials], step[maxPartials], blend[maxPartials];
+    auto ramp = 1.0f / (float) juce::jmax (1, numSamples);
+    for (int p = 0; p < numLanes; ++p)
+    {
+        phase[p] = phases[p];
+        increment[p] = increments[p];
+        amplitude[p] = amplitudes[p];
+        step[p] = (targets[p] - amplitudes[p]) * ramp;
+        blend[p] = blends[p];
+    }
+
+    // a group of lanes at a time across the whole block, so its phases and
+    // amplitudes stay in one register each
+    std::fill (dest, dest + numSamples, 0.0f);
+
+    for (int g = 0; g < numLanes; g += laneWidth)
+    {
+        auto* ph = phase + g;
+        auto* inc = increment + g;
+        auto* amp = amplitude + g;
+        auto* st = step + g;
+        auto* bl = blend + g;
+        auto* const* lo = lowerTables + g;
+        auto* const* hi = upperTables + g;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            alignas (16) juce::uint32 index[laneWidth];
+            alignas (16) float fraction[laneWidth], s0[laneWidth], s1[laneWidth], t0[laneWidth], t1[laneWidth], y[laneWidth];
+
+            for (int l = 0; l < laneWidth; ++l)
+            {
+                index[l] = ph[l] >> fractionBits;
+                fraction[l] = (float) (int) (ph[l] & fractionMask) * fractionScale;
+                ph[l] += inc[l];
+            }
+
+            // the gather, the only step that isn't lane-wise
+            for (int l = 0; l < laneWidth; ++l)
+            {
+                s0[l] = lo[l][index[l]];
+                s1[l] = lo[l][index[l] + 1];
+                t0[l] = hi[l][index[l]];
+                t1[l] = hi[l][index[l] + 1];
+            }
+
+            for (int l = 0; l < laneWidth; ++l)
+            {
+                auto a = s0[l] + fraction[l] * (s1[l] - s0[l]);
+                auto b = t0[l] + fraction[l] * (t1[l] - t0[l]);
+                y[l] = amp[l] * (a + bl[l] * (b - a));
+                amp[l] += st[l];
+            }
+
+            auto total = 0.0f;
+            for (int l = 0; l < laneWidth; ++l)
+                total += y[l];
+            dest[i] += total;
+        }
+    }
+
+    // the amplitudes land exactly on the targets, whatever the rounding of the ramps
+    std::copy (phase, phase + numLanes, phases);
+    std::copy (targets, targets + numLanes, amplitudes);
+
+    // then park the lanes that have faded out on the silent table
+    auto activeLanes = roundUpToLanes (numPartials);
+    for (int p = activeLanes; p < numLanes; ++p)
+    {
+        phases[p] = increments[p] = 0;
+        lowerTables[p] = upperTables[p] = silence;
+    }
+    numLanes = activeLanes;
+}
+
+void OscillatorBank::reset() noexcept
+{
+    std::fill (std::begin (phases), std::end (phases), 0u);
+    std::fill (std::begin (amplitudes), std::end (amplitudes), 0.0f);
+}
+
+//==============================================================================
+void OscillatorBank::save (DspStateWriter& writer) const
+{
+    for (int p = 0; p < maxPartials; ++p)
+    {
+        writer.write (phases[p]);
+        writer.write (amplitudes[p]);
+    }
+}
+
+bool OscillatorBank::load (DspStateReader& reader)
+{
+    juce::uint32 newPhases[maxPartials];
+    float newAmplitudes[maxPartials];
+    for (int p = 0; p < maxPartials; ++p)
+        if (! (reader.read (newPhases[p]) && reader.read (newAmplitudes[p])))
+            return false;
+
+    std::copy (std::begin (newPhases), std::end (newPhases), phases);
+    std::copy (std::begin (newAmplitudes), std::end (newAmplitudes), amplitudes);
+
+    // lanes past the current partials stay silent, whatever the snapshot had in them
+    for (int p = numPartials; p < maxPartials; ++p)
+    {
+        phases[p] = 0;
+        amplitudes[p] = 0.0f;
+    }
+    return true;
+}
+
+} // namespace mda
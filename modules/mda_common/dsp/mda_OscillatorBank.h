@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    mda_OscillatorBank.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    Single cycle tables of one waveform, band-limited per octave: table k
+    keeps the first 2^k harmonics, so it doesn't alias for any fundamental up
+    to nyquist / 2^k. Oscillators blend two neighbouring tables, so a sweeping
+    fundamental fades the top octave of harmonics in and out instead of
+    switching it.
+
+    Built once off the audio thread, then shared by every oscillator that
+    plays the waveform.
+*/
+class BandLimitedWavetable
+{
+public:
+    static constexpr int tableBits = 10;
+    static constexpr int tableSize = 1 << tableBits;   // samples per cycle
+    static constexpr int numTables = tableBits - 1;    // up to tableSize / 4 harmonics
+
+    /** amplitude (n) is the sine amplitude of harmonic n = 1, 2, ...; all the
+        tables get the gain that makes the richest one peak at 1.
+    */
+    explicit BandLimitedWavetable (const std::function<float (int)>& amplitude);
+
+    /** tableSize + 1 samples, the last one repeats the first for interpolation. */
+    const float* getTable (int index) const noexcept    { return data.data() + (size_t) index * (tableSize + 1); }
+
+    /** Where to read between the tables: blend from table floor (p) to the
+        next one by the fraction of p. Both stay below nyquist, and p moves
+        one table per octave, reaching the next table just as it would alias.
+    */
+    static float getTablePosition (float cyclesPerSample) noexcept
+    {
+        auto octaves = std::log2 (0.5f / juce::jmax (cyclesPerSample, 1.0e-9f));
+        return juce::jlimit (0.0f, (float) (numTables - 1), octaves - 1.0f);
+    }
+
+    size_t getHeapBytes() const noexcept                { return data.size() * sizeof (float); }
+
+private:
+    std::vector<float> data;
+
+    JUCE_DECLARE_NON_COPYABLE (BandLimitedWavetable)
+};
+
+//==============================================================================
+/**
+    Up to maxPartials wavetable oscillators summed into one output.
+
+    The partials run as lanes, laneWidth of them side by side in memory: the
+    32 bit phase accumulators, the table positions, the interpolation between
+    samples and tables and the weighting are fixed length loops the compiler
+    keeps in SIMD registers, and only the table reads go one partial at a time. Unused lanes in the last
+    group read a silent table, and partials dropped by setNumPartials() fade
+    out over the next render().
+
+    Frequencies hold for a render() call, the amplitudes ramp linearly to
+    their new values across it, so callers set both once per sub-block.
+*/
+class OscillatorBank
+{
+public:
+    static constexpr int laneWidth = 4;
+    static constexpr int maxPartials = 16;
+
+    OscillatorBank() noexcept;
+
+    void setNumPartials (int newNumPartials) noexcept;
+    int getNumPartials() const noexcept                 { return numPartials; }
+
+    /** Partials fade out over the octave below nyquist and are silent above it. */
+    void setPartial (int index, const BandLimitedWavetable& waveform, float cyclesPerSample, float amplitude) noexcept;
+
+    /** Writes the sum of the partials over dest. */
+    void render (float* dest, int numSamples) noexcept;
+
+    /** Phases back to the start of the cycle, amplitudes to 0. */
+    void reset() noexcept;
+
+    /** The phases & amplitudes, for the DSP state. */
+    void save (DspStateWriter& writer) const;
+    bool load (DspStateReader& reader);
+
+private:
+    // a whole table of zeros, so parked lanes can keep any phase
+    static constexpr float silence[BandLimitedWavetable::tableSize + 1] = {};
+
+    static int roundUpToLanes (int n) noexcept          { return (n + laneWidth - 1) / laneWidth * laneWidth; }
+
+    int numPartials = 0, numLanes = 0;
+
+    alignas (16) juce::uint32 phases[maxPartials] = {}, increments[maxPartials] = {};
+    alignas (16) float amplitudes[maxPartials] = {}, targets[maxPartials] = {};
+    alignas (16) float blends[maxPartials] = {}; // from the lower table to the upper
+    const float* lowerTables[maxPartials];
+    const float* upperTables[maxPartials];
+
+    JUCE_DECLARE_NON_COPYABLE (OscillatorBank)
+};
+
+} // namespace mda
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    mda_RampedValue.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    A linear ramp towards a target value, for de-zipping DSP coefficients.
+
+    Unlike juce::LinearSmoothedValue there is no per-sample call: render()
+    fills a whole run of samples with a loop the compiler can vectorise, so
+    the processing loop only reads the values back from an array. Expensive
+    coefficients that are only refreshed once per sub-block use skip().
+*/
+class RampedValue
+{
+public:
+    RampedValue() = default;
+
+    /** Sets the ramp length and jumps to the current target. */
+    void reset (double sampleRate, double rampLengthInSeconds) noexcept
+    {
+        stepsToTarget = juce::roundToInt (rampLengthInSeconds * sampleRate);
+        jumpToTarget();
+    }
+
+    void setCurrentAndTargetValue (float newValue) noexcept
+    {
+        current = target = newValue;
+        countdown = 0;
+    }
+
+    void setTargetValue (float newValue) noexcept
+    {
+        setTargetValue (newValue, stepsToTarget);
+    }
+
+    /** Ramps to newValue over numSteps samples instead of the usual ramp length. */
+    void setTargetValue (float newValue, int numSteps) noexcept
+    {
+        if (newValue == target)
+            return;
+
+        if (numSteps <= 0)
+        {
+            setCurrentAndTargetValue (newValue);
+            return;
+        }
+
+        target = newValue;
+        countdown = numSteps;
+        step = (target - current) / (float) countdown;
+    }
+
+    void jumpToTarget() noexcept            { setCurrentAndTargetValue (target); }
+
+    bool isSmoothing() const noexcept       { return countdown > 0; }
+    float getCurrentValue() const noexcept  { return current; }
+    float getTargetValue() const noexcept   { return target; }
+
+    /** Writes the next numSamples values of the ramp into dest. */
+    void render (float* dest, int numSamples) noexcept
+    {
+        auto numRamp = juce::jmin (numSamples, countdown);
+
+        for (int i = 0; i < numRamp; ++i)
+            dest[i] = current + step * (float) (i + 1);
+
+        skip (numRamp);
+
+        if (numRamp < numSamples)
+            juce::FloatVectorOperations::fill (dest + numRamp, current, numSamples - numRamp);
+    }
+
+    /** Advances the ramp by numSamples and returns the value reached. */
+    float skip (int numSamples) noexcept
+    {
+        if (numSamples >= countdown)
+        {
+            current = target;
+            countdown = 0;
+        }
+        else
+        {
+            current += step * (float) numSamples;
+            countdown -= numSamples;
+        }
+
+        return current;
+    }
+
+private:
+    float current = 0.0f, target = 0.0f, step = 0.0f;
+    int countdown = 0, stepsToTarget = 0;
+};
+
+} // namespace mda
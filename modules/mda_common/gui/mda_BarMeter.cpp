@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    mda_BarMeter.cpp
+
+  ==============================================================================
+*/
+
+namespace mda
+{
+
+BarMeter::BarMeter (Scale s, float minimum, float maximum)
+    : scale (s), minValue (minimum), maxValue (maximum)
+{
+    setOpaque (true);
+}
+
+void BarMeter::setValue (float newValue)
+{
+    value = newValue;
+    auto newWidth = valueToWidth (newValue);
+
+    if (newWidth == barWidth)
+        return;
+
+    auto changed = juce::Range<int>::between (barWidth, newWidth);
+    barWidth = newWidth;
+    repaint (changed.getStart(), 0, changed.getLength(), getHeight());
+}
+
+int BarMeter::valueToWidth (float newValue) const noexcept
+{
+    auto v = scale == Scale::decibels ? juce::Decibels::gainToDecibels (newValue, minValue)
+                                      : newValue;
+    auto proportion = juce::jlimit (0.0f, 1.0f, (v - minValue) / (maxValue - minValue));
+    return juce::roundToInt (proportion * (float) getWidth());
+}
+
+void BarMeter::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+
+    // above 0 dB the bar turns red
+    auto clipX = scale == Scale::decibels && maxValue > 0.0f
+                     ? juce::roundToInt ((0.0f - minValue) / (maxValue - minValue) * (float) getWidth())
+                     : getWidth();
+
+    g.setColour (juce::Colours::limegreen);
+    g.fillRect (0, 0, juce::jmin (barWidth, clipX), getHeight());
+
+    if (barWidth > clipX)
+    {
+        g.setColour (juce::Colours::red);
+        g.fillRect (clipX, 0, barWidth - clipX, getHeight());
+    }
+}
+
+void BarMeter::resized()
+{
+    barWidth = valueToWidth (value);
+}
+
+} // namespace mda
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    mda_BarMeter.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    Horizontal bar for levels and other live values coming from a MeterSource.
+
+    setValue() is cheap enough to call on every display refresh: it only
+    repaints the strip between the old and the new end of the bar, and only
+    when the bar has actually moved by a pixel.
+*/
+class BarMeter  : public juce::Component
+{
+public:
+    enum class Scale
+    {
+        decibels,   // values are gains, shown from minValue to maxValue dB
+        linear
+    };
+
+    BarMeter (Scale scale, float minValue, float maxValue);
+
+    void setValue (float newValue);
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+private:
+    int valueToWidth (float newValue) const noexcept;
+
+    const Scale scale;
+    const float minValue, maxValue;
+    float value = 0.0f;
+    int barWidth = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BarMeter)
+};
+
+} // namespace mda
@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    mda_ProcessorEditor.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    Editor for the ports that don't need a hand laid out one: a label and a
+    slider for each row of the parameter table, the input & output meters,
+    up to two meters for the plugin specific values of the MeterFrame, and the
+    DSP state toggle next to the credits.
+
+    ProcessorType is the plugin's mda::Processor, the rows follow its table.
+*/
+template <typename ProcessorType>
+class ProcessorEditor  : public juce::AudioProcessorEditor
+{
+public:
+    /** A row showing MeterFrame::values[n], in the order given. */
+    struct ValueMeter
+    {
+        const char* name;
+        BarMeter::Scale scale;
+        float minValue, maxValue;
+    };
+
+    ProcessorEditor (ProcessorType& p, std::initializer_list<ValueMeter> valueMeterRows = {})
+        : AudioProcessorEditor (&p), audioProcessor (p)
+    {
+        jassert (valueMeterRows.size() <= std::size (meterFrame.values));
+
+        for (auto& spec : ProcessorType::parameters)
+        {
+            auto* row = parameterRows.add (new ParameterRow());
+            row->label.setText (spec.name, juce::dontSendNotification);
+            addAndMakeVisible (row->label);
+            addAndMakeVisible (row->slider);
+            row->attachment.reset (new juce::AudioProcessorValueTreeState::SliderAttachment (p.apvts, spec.id, row->slider));
+        }
+
+        inputMeterLabel.setText ("Input", juce::dontSendNotification);
+        outputMeterLabel.setText ("Output", juce::dontSendNotification);
+        for (auto* c : std::initializer_list<juce::Component*> { &inputMeterLabel, &inputMeterL, &inputMeterR,
+                                                                 &outputMeterLabel, &outputMeterL, &outputMeterR })
+            addAndMakeVisible (c);
+
+        for (auto& v : valueMeterRows)
+        {
+            auto* row = valueRows.add (new ValueRow (v));
+            addAndMakeVisible (row->label);
+            addAndMakeVisible (row->meter);
+        }
+
+        dspStateButton.setToggleState (audioProcessor.getSavesDspState(), juce::dontSendNotification);
+        dspStateButton.onClick = [this] { audioProcessor.setSavesDspState (dspStateButton.getToggleState()); };
+        addAndMakeVisible (dspStateButton);
+
+        audioProcessor.meters.addConsumer();
+
+        setSize (paramSliderWidth + paramLabelWidth, juce::jmax (100, paramControlHeight * getNumRows()));
+    }
+
+    ~ProcessorEditor() override
+    {
+        audioProcessor.meters.removeConsumer();
+    }
+
+    //==============================================================================
+    void paint (juce::Graphics& g) override
+    {
+        g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+        auto r = getLocalBounds();
+        auto labelRect = r.removeFromBottom (r.getHeight() / getNumRows());
+        g.setColour (juce::Colours::white);
+        g.setFont (10.0f);
+        g.drawFittedText ("mda plugins (c) Paul Kellett - JUCE port by lucaji.github.io", labelRect, juce::Justification::right, 1);
+    }
+
+    void resized() override
+    {
+        auto r = getLocalBounds();
+        auto rowHeight = r.getHeight() / getNumRows();
+
+        // shares the bottom row with the credits
+        dspStateButton.setBounds (r.removeFromBottom (rowHeight).removeFromLeft (paramLabelWidth));
+
+        auto nextRow = [&r, rowHeight]
+        {
+            auto row = r.removeFromTop (rowHeight);
+            return std::make_pair (row.removeFromLeft (paramLabelWidth), row.withWidth (paramSliderWidth));
+        };
+
+        for (auto* row : parameterRows)
+        {
+            auto [labelRect, sliderRect] = nextRow();
+            row->label.setBounds (labelRect);
+            row->slider.setBounds (sliderRect);
+        }
+
+        // stereo meters are split into two bars
+        auto placeStereo = [&] (juce::Label& label, BarMeter& left, BarMeter& right)
+        {
+            auto [labelRect, meterRect] = nextRow();
+            label.setBounds (labelRect);
+            meterRect = meterRect.reduced (4, rowHeight / 4);
+            auto half = meterRect.getHeight() / 2 - 1;
+            left.setBounds (meterRect.removeFromTop (half));
+            right.setBounds (meterRect.removeFromBottom (half));
+        };
+        placeStereo (inputMeterLabel, inputMeterL, inputMeterR);
+        placeStereo (outputMeterLabel, outputMeterL, outputMeterR);
+
+        for (auto* row : valueRows)
+        {
+            auto [labelRect, meterRect] = nextRow();
+            row->label.setBounds (labelRect);
+            row->meter.setBounds (meterRect.reduced (4, rowHeight / 4));
+        }
+    }
+
+private:
+    enum
+    {
+        paramControlHeight = 40,
+        paramLabelWidth    = 120,
+        paramSliderWidth   = 300
+    };
+
+    struct ParameterRow
+    {
+        juce::Label label;
+        juce::Slider slider;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> attachment;
+    };
+
+    struct ValueRow
+    {
+        explicit ValueRow (const ValueMeter& v) : meter (v.scale, v.minValue, v.maxValue)
+        {
+            label.setText (v.name, juce::dontSendNotification);
+        }
+
+        juce::Label label;
+        BarMeter meter;
+    };
+
+    // parameters, input & output meters, value meters, credits
+    int getNumRows() const noexcept     { return parameterRows.size() + 2 + valueRows.size() + 1; }
+
+    // called on every display refresh, only repaints the meters that moved
+    void updateMeters()
+    {
+        if (! audioProcessor.meters.pull (meterFrame))
+            return;
+
+        inputMeterL.setValue (meterFrame.inputPeak[0]);
+        inputMeterR.setValue (meterFrame.inputPeak[1]);
+        outputMeterL.setValue (meterFrame.outputPeak[0]);
+        outputMeterR.setValue (meterFrame.outputPeak[1]);
+
+        for (int i = 0; i < valueRows.size(); ++i)
+            valueRows[i]->meter.setValue (meterFrame.values[i]);
+    }
+
+    ProcessorType& audioProcessor;
+
+    juce::OwnedArray<ParameterRow> parameterRows;
+    juce::OwnedArray<ValueRow> valueRows;
+
+    juce::Label inputMeterLabel, outputMeterLabel;
+    BarMeter inputMeterL { BarMeter::Scale::decibels, -60.0f, 6.0f };
+    BarMeter inputMeterR { BarMeter::Scale::decibels, -60.0f, 6.0f };
+    BarMeter outputMeterL { BarMeter::Scale::decibels, -60.0f, 6.0f };
+    BarMeter outputMeterR { BarMeter::Scale::decibels, -60.0f, 6.0f };
+
+    // opt-in snapshot of the live DSP state in the saved state
+    juce::ToggleButton dspStateButton { "Save DSP state" };
+
+    MeterFrame meterFrame;
+    juce::VBlankAttachment vBlankAttachment { this, [this] { updateMeters(); } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorEditor)
+};
+
+} // namespace mda
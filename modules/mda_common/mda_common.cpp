@@ -0,0 +1,24 @@
+/*
+  ==============================================================================
+
+    Shared code for the mda plugins JUCE port.
+
+  ==============================================================================
+*/
+
+#ifdef MDA_COMMON_H_INCLUDED
+ /* When you add this cpp file to your project, you mustn't include it in a file where you've
+    already included any other headers - just put it inside a file on its own, possibly with your config
+    flags preceding it, but don't include anything else. That also includes avoiding any automatic prefix
+    header files that the compiler may be using.
+ */
+ #error "Incorrect use of JUCE cpp file"
+#endif
+
+#include "mda_common.h"
+
+#include "dsp/mda_OscillatorBank.cpp"
+#include "utils/mda_CoefficientUpdater.cpp"
+#include "state/mda_BinaryState.cpp"
+#include "state/mda_DspState.cpp"
+#include "gui/mda_BarMeter.cpp"
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    Shared code for the mda plugins JUCE port.
+
+  ==============================================================================
+*/
+
+/*******************************************************************************
+ The block below describes the properties of this module, and is read by
+ the Projucer to automatically generate project code that uses it.
+ For details about the syntax and how to create or use a module, see the
+ JUCE Module Format.md file.
+
+
+ BEGIN_JUCE_MODULE_DECLARATION
+
+  ID:                 mda_common
+  vendor:             lucaji
+  version:            1.0.0
+  name:               mda plugins common code
+  description:        DSP and processor helpers shared by the mda plugin ports
+  website:            https://lucaji.github.io
+  license:            MIT
+  minimumCppStandard: 17
+
+  dependencies:       juce_audio_processors, juce_dsp, juce_gui_basics
+
+ END_JUCE_MODULE_DECLARATION
+
+*******************************************************************************/
+
+
+#pragma once
+#define MDA_COMMON_H_INCLUDED
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+//==============================================================================
+/** Config: MDA_PROFILE_BLOCKS
+    Logs the fixed per-block and the per-sample cost of processBlock, see mda::BlockProfiler.
+*/
+#ifndef MDA_PROFILE_BLOCKS
+ #define MDA_PROFILE_BLOCKS 0
+#endif
+
+#include "dsp/mda_MappingTable.h"
+#include "dsp/mda_DspBuffer.h"
+#include "dsp/mda_BiquadCascade.h"
+#include "dsp/mda_RampedValue.h"
+#include "utils/mda_CoefficientUpdater.h"
+#include "utils/mda_MeterSource.h"
+#include "utils/mda_BlockProfiler.h"
+#include "utils/mda_CheckSample.h"
+#include "state/mda_BinaryState.h"
+#include "state/mda_DspState.h"
+#include "dsp/mda_OscillatorBank.h"
+#include "gui/mda_BarMeter.h"
+#include "processor/mda_ParameterTable.h"
+#include "processor/mda_Processor.h"
+#include "gui/mda_ProcessorEditor.h"
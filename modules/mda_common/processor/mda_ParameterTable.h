@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    mda_ParameterTable.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    One row of a plugin's constexpr parameter table.
+
+    The table lists the parameters in index order, which is also the order of
+    the APVTS layout, the dirty bits, the factory program values and the binary
+    state, so appending is the only safe way to add a parameter.
+*/
+struct ParameterSpec
+{
+    const char* id;
+    const char* name;
+    float minimum, maximum, interval;
+    float defaultValue;
+    const char* label = "";
+    juce::String (*valueToText) (float value, int maximumStringLength) = nullptr;
+
+    /** Plain value for a normalised one, without going through the parameter object. */
+    constexpr float convertFrom0to1 (float normalised) const noexcept
+    {
+        return minimum + normalised * (maximum - minimum);
+    }
+
+    std::unique_ptr<juce::AudioParameterFloat> create() const
+    {
+        auto attributes = juce::AudioParameterFloatAttributes().withLabel (label);
+
+        if (valueToText != nullptr)
+            attributes = attributes.withStringFromValueFunction (valueToText);
+
+        return std::make_unique<juce::AudioParameterFloat> (juce::ParameterID (id, 1),
+                                                            name,
+                                                            juce::NormalisableRange<float> (minimum, maximum, interval),
+                                                            defaultValue,
+                                                            attributes);
+    }
+};
+
+//==============================================================================
+/** A factory program, as normalised values in parameter index order. */
+template <int numParameters>
+struct Program
+{
+    const char* name;
+    float values[numParameters];
+};
+
+} // namespace mda
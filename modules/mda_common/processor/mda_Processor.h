@@ -0,0 +1,469 @@
+/*
+  ==============================================================================
+
+    mda_Processor.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+/** Main bus layouts the plugins accept, each gets its own kernel instantiation. */
+enum class ChannelLayout { mono, monoToStereo, stereo };
+
+//==============================================================================
+/**
+    Base class for the mda effect ports, written once for all of them.
+
+    Derived is the plugin's processor (CRTP) and Description a struct with the
+    plugin's compile-time tables, which the base also inherits from so their
+    names can be used unqualified:
+
+      name, stateTag              plugin name & 4-character binary state tag
+      enum ParameterIndex         kXxx indices, ending with kNumParameters
+      parameters[]                constexpr mda::ParameterSpec table, in index order
+      programs[]                  constexpr mda::Program<kNumParameters> table
+      struct Coefficients         the snapshot the coefficient thread calculates
+      sidechainName               optional, adds a second input bus (e.g. a vocoder's
+                                  carrier), which the kernel reads with getBusBuffer()
+
+    and Derived provides, all called without virtual dispatch:
+
+      void update (Coefficients&, juce::uint32 changed, float fs, const float* values) const;
+      void applyCoefficients (const Coefficients&, int rampSamples);
+      template <typename SampleType, ChannelLayout, bool highQuality>
+      void processChannels (juce::AudioBuffer<SampleType>&, int numSamples);
+      void reset() override;
+
+    plus, where needed, prepareResources() (given the rate and the largest
+    block the host will send) and prepareSmoothing() for prepareToPlay,
+    beginBlock() and endBlock() around the kernel, pushMeters() for the
+    editor, dspHeapBytes() for getHeapBytes() and saveDspState() /
+    loadDspState() for the optional DSP state snapshot.
+    The defaults here do nothing. A plugin with latency calls reportLatency(),
+    from prepareResources() or from the audio thread.
+
+    Construction only builds the parameters: DSP buffers belong in
+    prepareResources() and the coefficient thread starts on the first prepare,
+    so hosts can scan and load sessions cheaply.
+
+    The base owns the APVTS, the parameter listener that feeds the dirty bits,
+    the coefficient updater and program switching, bus layouts, the sample type
+    and layout dispatch, metering and the binary state.
+*/
+template <typename Derived, typename Description>
+class Processor  : public juce::AudioProcessor,
+                   public Description,
+                   private juce::AudioProcessorParameter::Listener,
+                   private juce::AsyncUpdater
+{
+public:
+    using Coefficients = typename Description::Coefficients;
+
+    static constexpr int numParameters = Description::kNumParameters;
+    static constexpr int numPrograms = (int) std::size (Description::programs);
+
+    static_assert (std::size (Description::parameters) == (size_t) numParameters,
+                   "the parameter table must have one row per parameter index");
+    static_assert (numParameters <= 32, "one dirty bit per parameter");
+
+    //==============================================================================
+    Processor()
+        : AudioProcessor (createBusesProperties())
+    {
+        for (int i = 0; i < numParameters; ++i) {
+            parameterPointers[(size_t) i] = dynamic_cast<juce::AudioParameterFloat*> (apvts.getParameter (Description::parameters[i].id));
+            jassert (parameterPointers[(size_t) i] != nullptr && parameterPointers[(size_t) i]->getParameterIndex() == i);
+            parameterPointers[(size_t) i]->addListener (this);
+        }
+    }
+
+    ~Processor() override
+    {
+        for (auto* param : parameterPointers)
+            param->removeListener (this);
+    }
+
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override
+    {
+        // offline renders get the high quality kernels, decided here so playback never checks
+        highQuality = isNonRealtime();
+
+        coefficients.release(); // the coefficient thread must not run while tables are rebuilt
+        derived().prepareResources (sampleRate, samplesPerBlock);
+
+        meters.prepare (sampleRate);
+
+        for (int i = 0; i < numPrograms; ++i)
+            derived().update (programCoefficients[(size_t) i], ~0u, (float) sampleRate, Description::programs[i].values);
+        programFadeSamples = juce::roundToInt (programFadeTime * sampleRate);
+
+        // sample rate may have changed, start from the current settings without ramping
+        coefficients.prepare (sampleRate);
+        if (auto* c = coefficients.pull())
+            derived().applyCoefficients (*c, -1);
+
+        derived().prepareSmoothing (sampleRate);
+        derived().reset();
+
+        if (savesDspState.load())
+            reserveDspStateStorage (0);
+
+        // prepareToPlay is where hosts expect a new latency, no need to wait
+        cancelPendingUpdate();
+        setLatencySamples (latencySamples.load());
+
+        // a snapshot restored before the host prepared us, e.g. when loading a session
+        if (pendingDspState != nullptr)
+        {
+            if (pendingDspState->getSampleRate() == sampleRate && ! derived().loadDspState (*pendingDspState))
+                derived().reset();
+            pendingDspState.reset();
+        }
+        preparedSampleRate = sampleRate;
+    }
+
+    void releaseResources() override
+    {
+        coefficients.release();
+    }
+
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override
+    {
+        auto in = layouts.getMainInputChannelSet(), out = layouts.getMainOutputChannelSet();
+
+        if (out != juce::AudioChannelSet::mono() && out != juce::AudioChannelSet::stereo())
+            return false;
+
+        if constexpr (hasSidechain)
+        {
+            auto sidechain = layouts.getChannelSet (true, 1);
+            if (! sidechain.isDisabled() && sidechain != juce::AudioChannelSet::mono() && sidechain != juce::AudioChannelSet::stereo())
+                return false;
+        }
+
+        // mono in, mono or stereo out, or stereo in & out
+        return in == juce::AudioChannelSet::mono() || in == out;
+    }
+
+    // pick the kernel once here instead of checking the channel count per sample
+    void processorLayoutsChanged() override
+    {
+        if (getMainBusNumOutputChannels() < 2)
+            channelLayout = ChannelLayout::mono;
+        else if (getMainBusNumInputChannels() < 2)
+            channelLayout = ChannelLayout::monoToStereo;
+        else
+            channelLayout = ChannelLayout::stereo;
+    }
+
+    void processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) override    { process (buffer); }
+    void processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer&) override   { process (buffer); }
+    bool supportsDoublePrecisionProcessing() const override                               { return true; }
+
+    //==============================================================================
+    bool hasEditor() const override                     { return true; }
+    const juce::String getName() const override         { return Description::name; }
+    bool acceptsMidi() const override                   { return false; }
+    bool producesMidi() const override                  { return false; }
+    bool isMidiEffect() const override                  { return false; }
+    double getTailLengthSeconds() const override        { return 0.0; }
+
+    //==============================================================================
+    int getNumPrograms() override                       { return numPrograms; }
+    int getCurrentProgram() override                    { return currentProgram; }
+    void changeProgramName (int, const juce::String&) override {}
+
+    void setCurrentProgram (int index) override
+    {
+        index = juce::jlimit (0, numPrograms - 1, index);
+        currentProgram = index;
+
+        // the audio thread switches to the precalculated coefficients straight away,
+        // the parameters follow so the host and editor show the new values; they
+        // change one at a time, so the coefficient thread waits until all have
+        // rather than publish a mix of the old and new program
+        coefficients.suspend();
+        pendingProgram.store (index);
+        for (int i = 0; i < numParameters; ++i)
+            parameterPointers[(size_t) i]->setValueNotifyingHost (Description::programs[index].values[i]);
+        coefficients.resume();
+    }
+
+    const juce::String getProgramName (int index) override
+    {
+        if (juce::isPositiveAndBelow (index, numPrograms))
+            return Description::programs[index].name;
+        return {};
+    }
+
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override
+    {
+        BinaryState::write (*this, Description::stateTag, destData);
+
+        if (savesDspState.load() && preparedSampleRate > 0.0)
+        {
+            // the audio thread is only held off while the state is copied into
+            // storage reserved beforehand, encoding & compressing wait until after;
+            // if the copy didn't fit it is taken again, into storage grown out here
+            reserveDspStateStorage (dspStateStorage.getSize());
+            for (int attempt = 0; attempt < 2; ++attempt)
+            {
+                DspStateWriter writer (preparedSampleRate, dspStateStorage);
+                {
+                    const juce::ScopedLock sl (getCallbackLock());
+                    derived().saveDspState (writer);
+                }
+
+                if (writer.isComplete())
+                {
+                    BinaryState::appendChunk (destData, dspStateTag, writer.getCompressedData());
+                    break;
+                }
+                reserveDspStateStorage (writer.getSize());
+            }
+        }
+        else if (savesDspState.load() && pendingDspState != nullptr)
+        {
+            BinaryState::appendChunk (destData, dspStateTag, pendingDspSnapshot); // loaded but never played
+        }
+    }
+
+    void setStateInformation (const void* data, int sizeInBytes) override
+    {
+        if (BinaryState::read (*this, Description::stateTag, data, sizeInBytes))
+        {
+            juce::MemoryBlock snapshot;
+            savesDspState = BinaryState::findChunk (data, sizeInBytes, dspStateTag, snapshot);
+            if (savesDspState.load())
+                restoreDspState (snapshot);
+            return;
+        }
+
+        // state saved as XML by older versions
+        std::unique_ptr<juce::XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
+        if (xmlState != nullptr && xmlState->hasTagName (apvts.state.getType()))
+            apvts.replaceState (juce::ValueTree::fromXml (*xmlState));
+    }
+
+    //==============================================================================
+    /** Heap bytes owned by this instance: the processor object, which hosts create
+        with new, plus the DSP buffers and tables reported by Derived, which are
+        only allocated in prepareToPlay. The parameters and APVTS cost the same for
+        every instance of a plugin; mdaBenchmark measures the total. Buffers owned
+        by JUCE classes that don't report their size are estimated by Derived.
+    */
+    size_t getHeapBytes() const noexcept    { return sizeof (Derived) + derived().dspHeapBytes(); }
+
+    /** Opt-in: also save the live DSP state (delay lines, filter states, lfo phases),
+        so a session or a stopped render resumes with the exact tail it stopped on.
+        A state saved this way turns it on again when loaded.
+    */
+    void setSavesDspState (bool shouldSave) noexcept    { savesDspState = shouldSave; }
+    bool getSavesDspState() const noexcept              { return savesDspState.load(); }
+
+    //==============================================================================
+    juce::AudioProcessorValueTreeState apvts { *this, nullptr, "Parameters", createParameterLayout() };
+
+    // level meters, plus two plugin specific values for the editor
+    MeterSource meters;
+
+protected:
+    static constexpr int kSubBlockSize = 32;
+    static constexpr double kSmoothingTime = 0.05; // in seconds
+
+    static constexpr juce::uint32 dirtyBit (int index) { return 1u << index; }
+
+    /** The latency the host should compensate for. Safe on the audio thread, which
+        mustn't call setLatencySamples(): a change is passed on from the message
+        thread, or by prepareToPlay() when made while preparing.
+    */
+    void reportLatency (int samples) noexcept
+    {
+        if (latencySamples.exchange (samples) != samples)
+            triggerAsyncUpdate();
+    }
+
+    juce::AudioParameterFloat& parameter (int index) const noexcept { return *parameterPointers[(size_t) index]; }
+
+    // default hooks, hidden by Derived where it has something to do
+    void prepareResources (double, int) {}
+    void prepareSmoothing (double) {}
+    void beginBlock() {}
+    void endBlock() {}
+    void pushMeters (int numSamples) { meters.push (numSamples, 0.0f, 0.0f); }
+    size_t dspHeapBytes() const noexcept { return 0; }
+    void saveDspState (DspStateWriter&) const {}
+    bool loadDspState (DspStateReader&) { return false; }
+
+    // calculated on the shared coefficient thread, picked up at the start of each block
+    CoefficientUpdater<Coefficients> coefficients { [this] (Coefficients& c, juce::uint32 changed, double sampleRate)
+                                                    {
+                                                        float values[numParameters];
+                                                        for (int i = 0; i < numParameters; ++i)
+                                                            values[i] = parameterPointers[(size_t) i]->getValue();
+                                                        derived().update (c, changed, (float) sampleRate, values);
+                                                    } };
+
+    ChannelLayout channelLayout = ChannelLayout::stereo;
+    bool highQuality = false;
+
+private:
+    template <typename D, typename = void>
+    struct HasSidechain : std::false_type {};
+    template <typename D>
+    struct HasSidechain<D, std::void_t<decltype (D::sidechainName)>> : std::true_type {};
+    static constexpr bool hasSidechain = HasSidechain<Description>::value;
+
+    static BusesProperties createBusesProperties()
+    {
+        auto buses = BusesProperties()
+                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true);
+
+        if constexpr (hasSidechain)
+            buses = buses.withInput (Description::sidechainName, juce::AudioChannelSet::stereo(), true);
+
+        return buses;
+    }
+
+    Derived& derived() noexcept { return static_cast<Derived&> (*this); }
+    const Derived& derived() const noexcept { return static_cast<const Derived&> (*this); }
+
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
+    {
+        juce::AudioProcessorValueTreeState::ParameterLayout layout;
+        for (auto& spec : Description::parameters)
+            layout.add (spec.create());
+        return layout;
+    }
+
+    // one bit per parameter, so update() only recalculates what depends on it
+    void parameterValueChanged (int parameterIndex, float) override
+    {
+        coefficients.markDirty (dirtyBit (parameterIndex));
+    }
+    void parameterGestureChanged (int, bool) override {}
+
+    void handleAsyncUpdate() override
+    {
+        setLatencySamples (latencySamples.load());
+    }
+
+    template <typename SampleType>
+    void process (juce::AudioBuffer<SampleType>& buffer)
+    {
+        juce::ScopedNoDenormals noDenormals;
+        profiler.beginBlock();
+
+        // the main output is the only output bus and every kernel writes all of it,
+        // so there are no unused channels to clear; a sidechain follows the main input
+        if (isNonRealtime())
+            coefficients.updateNow(); // keep offline renders sample-exact
+        if (auto* c = coefficients.pull())
+            derived().applyCoefficients (*c, -1);
+        if (pendingProgram.load (std::memory_order_relaxed) >= 0) {
+            // short crossfade to the precalculated program
+            derived().applyCoefficients (programCoefficients[(size_t) pendingProgram.exchange (-1)], programFadeSamples);
+        }
+
+        derived().beginBlock();
+
+        auto numSamples = buffer.getNumSamples();
+        auto metering = meters.isActive();
+        if (metering)
+            meters.measureInput (buffer, numSamples);
+
+        profiler.beginKernel();
+        if (highQuality)
+            processLayout<SampleType, true> (buffer, numSamples);
+        else
+            processLayout<SampleType, false> (buffer, numSamples);
+        profiler.endKernel();
+
+        if (metering) {
+            meters.measureOutput (buffer, numSamples);
+            derived().pushMeters (numSamples);
+        }
+
+        derived().endBlock();
+        profiler.endBlock (numSamples);
+    }
+
+    template <typename SampleType, bool hq>
+    void processLayout (juce::AudioBuffer<SampleType>& buffer, int numSamples)
+    {
+        auto& d = derived();
+        switch (channelLayout)
+        {
+            case ChannelLayout::mono:         d.template processChannels<SampleType, ChannelLayout::mono, hq> (buffer, numSamples); break;
+            case ChannelLayout::monoToStereo: d.template processChannels<SampleType, ChannelLayout::monoToStereo, hq> (buffer, numSamples); break;
+            case ChannelLayout::stereo:       d.template processChannels<SampleType, ChannelLayout::stereo, hq> (buffer, numSamples); break;
+        }
+    }
+
+    std::array<juce::AudioParameterFloat*, (size_t) numParameters> parameterPointers {};
+
+    // factory programs, with their coefficients precalculated in prepareToPlay so a
+    // program change only has to ramp to them on the audio thread
+    static constexpr double programFadeTime = 0.01; // in seconds
+    std::array<Coefficients, (size_t) numPrograms> programCoefficients;
+    std::atomic<int> pendingProgram { -1 };
+    int currentProgram = 0;
+    int programFadeSamples = 0;
+
+    BlockProfiler profiler { Description::name };
+
+    std::atomic<int> latencySamples { 0 }; // as last reported, see reportLatency()
+
+    // optional DSP state snapshot, saved as a chunk after the parameters
+    static constexpr const char* dspStateTag = "dsp ";
+    std::atomic<bool> savesDspState { false };
+    std::unique_ptr<DspStateReader> pendingDspState;
+    juce::MemoryBlock pendingDspSnapshot;
+    double preparedSampleRate = 0.0;
+
+    // the raw copy getStateInformation() takes under the callback lock
+    juce::MemoryBlock dspStateStorage;
+
+    // at least the DSP buffers plus room for the scalar state, or what the last copy needed
+    void reserveDspStateStorage (size_t minimumSize)
+    {
+        auto size = juce::jmax (minimumSize, derived().dspHeapBytes() + sizeof (Derived));
+        if (dspStateStorage.getSize() < size)
+            dspStateStorage.setSize (size);
+    }
+
+    void restoreDspState (const juce::MemoryBlock& snapshot)
+    {
+        auto reader = std::make_unique<DspStateReader> (snapshot);
+        if (! reader->isValid())
+            return;
+
+        if (reader->getSampleRate() != preparedSampleRate)
+        {
+            pendingDspState = std::move (reader); // picked up by the next prepareToPlay
+            pendingDspSnapshot = snapshot;
+            return;
+        }
+
+        // already running at the snapshot's rate: land on the loaded parameters
+        // without ramping, then continue from the snapshot
+        const juce::ScopedLock sl (getCallbackLock());
+        coefficients.updateNow();
+        if (auto* c = coefficients.pull())
+            derived().applyCoefficients (*c, -1);
+        derived().prepareSmoothing (preparedSampleRate);
+        if (! derived().loadDspState (*reader))
+            derived().reset();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Processor)
+};
+
+} // namespace mda
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    mda_BinaryState.cpp
+
+  ==============================================================================
+*/
+
+namespace mda
+{
+
+static float getPlainValue (const juce::AudioProcessorParameter& param)
+{
+    if (auto* ranged = dynamic_cast<const juce::RangedAudioParameter*> (&param))
+        return ranged->convertFrom0to1 (param.getValue());
+
+    return param.getValue();
+}
+
+static float getNormalisedValue (const juce::AudioProcessorParameter& param, float plainValue)
+{
+    if (auto* ranged = dynamic_cast<const juce::RangedAudioParameter*> (&param))
+        return ranged->convertTo0to1 (plainValue);
+
+    return plainValue;
+}
+
+void BinaryState::write (const juce::AudioProcessor& processor, const char* tag, juce::MemoryBlock& destData)
+{
+    const auto& params = processor.getParameters();
+    destData.setSize ((size_t) (headerSize + params.size() * (int) sizeof (float)));
+
+    auto* bytes = static_cast<char*> (destData.getData());
+    std::memcpy (bytes, tag, 4);
+
+    const auto version = juce::ByteOrder::swapIfBigEndian (currentVersion);
+    const auto numParams = juce::ByteOrder::swapIfBigEndian ((juce::uint16) params.size());
+    std::memcpy (bytes + 4, &version, sizeof (version));
+    std::memcpy (bytes + 6, &numParams, sizeof (numParams));
+
+    for (int i = 0; i < params.size(); ++i)
+    {
+        auto value = getPlainValue (*params.getUnchecked (i));
+        juce::uint32 bits;
+        std::memcpy (&bits, &value, sizeof (bits));
+        bits = juce::ByteOrder::swapIfBigEndian (bits);
+        std::memcpy (bytes + headerSize + i * (int) sizeof (float), &bits, sizeof (bits));
+    }
+}
+
+bool BinaryState::read (juce::AudioProcessor& processor, const char* tag, const void* data, int sizeInBytes)
+{
+    auto* bytes = static_cast<const char*> (data);
+
+    if (data == nullptr || sizeInBytes < headerSize || std::memcmp (bytes, tag, 4) != 0)
+        return false;
+
+    juce::uint16 version, numStored;
+    std::memcpy (&version, bytes + 4, sizeof (version));
+    std::memcpy (&numStored, bytes + 6, sizeof (numStored));
+    version = juce::ByteOrder::swapIfBigEndian (version);
+    numStored = juce::ByteOrder::swapIfBigEndian (numStored);
+
+    if (version == 0 || sizeInBytes < headerSize + (int) numStored * (int) sizeof (float))
+        return false;
+
+    const auto& params = processor.getParameters();
+
+    for (int i = 0; i < params.size(); ++i)
+    {
+        auto* param = params.getUnchecked (i);
+
+        if (i < (int) numStored)
+        {
+            juce::uint32 bits;
+            std::memcpy (&bits, bytes + headerSize + i * (int) sizeof (float), sizeof (bits));
+            bits = juce::ByteOrder::swapIfBigEndian (bits);
+            float value;
+            std::memcpy (&value, &bits, sizeof (value));
+            param->setValueNotifyingHost (getNormalisedValue (*param, value));
+        }
+        else
+        {
+            param->setValueNotifyingHost (param->getDefaultValue());
+        }
+    }
+
+    return true;
+}
+
+void BinaryState::appendChunk (juce::MemoryBlock& destData, const char* chunkTag, const juce::MemoryBlock& chunk)
+{
+    const auto size = juce::ByteOrder::swapIfBigEndian ((juce::uint32) chunk.getSize());
+    destData.append (chunkTag, 4);
+    destData.append (&size, sizeof (size));
+    destData.append (chunk.getData(), chunk.getSize());
+}
+
+bool BinaryState::findChunk (const void* data, int sizeInBytes, const char* chunkTag, juce::MemoryBlock& chunk)
+{
+    auto* bytes = static_cast<const char*> (data);
+
+    if (data == nullptr || sizeInBytes < headerSize)
+        return false;
+
+    juce::uint16 numStored;
+    std::memcpy (&numStored, bytes + 6, sizeof (numStored));
+    auto pos = (juce::int64) headerSize + (juce::int64) juce::ByteOrder::swapIfBigEndian (numStored) * (juce::int64) sizeof (float);
+
+    while (pos + 8 <= sizeInBytes)
+    {
+        juce::uint32 size;
+        std::memcpy (&size, bytes + pos + 4, sizeof (size));
+        size = juce::ByteOrder::swapIfBigEndian (size);
+
+        if (pos + 8 + (juce::int64) size > sizeInBytes)
+            return false;
+
+        if (std::memcmp (bytes + pos, chunkTag, 4) == 0)
+        {
+            chunk.replaceAll (bytes + pos + 8, size);
+            return true;
+        }
+
+        pos += 8 + (juce::int64) size;
+    }
+
+    return false;
+}
+
+} // namespace mda
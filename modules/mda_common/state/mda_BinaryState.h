@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    mda_BinaryState.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    Compact, versioned binary format for a plugin's parameter state.
+
+    Layout, little endian:
+      0   4-character plugin tag
+      4   uint16 format version
+      6   uint16 number of parameters
+      8   float plain value of each parameter, in parameter index order
+
+    followed by optional chunks, each a 4-character tag, a uint32 size and
+    the data. Versions that don't know a chunk skip it, and older versions
+    never look past the parameters.
+
+    Parameters are only ever appended, so each value stays at a fixed offset
+    in every version. Loading sets every parameter directly, without going
+    through XML or the APVTS value tree; the parameter listeners coalesce the
+    changes into a single coefficient update. Parameters missing from an
+    older blob are reset to their defaults.
+*/
+struct BinaryState
+{
+    static constexpr juce::uint16 currentVersion = 1;
+    static constexpr int headerSize = 8;
+
+    /** Replaces destData with the processor's parameter values. tag must be 4 characters. */
+    static void write (const juce::AudioProcessor& processor, const char* tag, juce::MemoryBlock& destData);
+
+    /** Returns false, without changing anything, if data isn't a binary state
+        with this tag, e.g. a state saved as XML by an older version.
+    */
+    static bool read (juce::AudioProcessor& processor, const char* tag, const void* data, int sizeInBytes);
+
+    /** Appends an optional chunk to a state written by write(). chunkTag must be 4 characters. */
+    static void appendChunk (juce::MemoryBlock& destData, const char* chunkTag, const juce::MemoryBlock& chunk);
+
+    /** Copies the chunk with this tag into chunk, returns false if the state has none. */
+    static bool findChunk (const void* data, int sizeInBytes, const char* chunkTag, juce::MemoryBlock& chunk);
+};
+
+} // namespace mda
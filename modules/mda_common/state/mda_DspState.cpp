@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    mda_DspState.cpp
+
+  ==============================================================================
+*/
+
+namespace mda
+{
+
+// silence shorter than this is cheaper to store than to describe
+static constexpr size_t minSilentRun = 16;
+
+static bool isSilent (float sample) noexcept
+{
+    juce::uint32 bits;
+    std::memcpy (&bits, &sample, sizeof (bits));
+    return bits == 0; // exactly +0, so restoring zeros is exact
+}
+
+// runs of (silent count, literal count, literal samples) until numSamples are covered
+static void encodeSamples (juce::MemoryOutputStream& stream, const float* samples, size_t numSamples)
+{
+    stream.writeInt64 ((juce::int64) numSamples);
+
+    size_t pos = 0;
+    while (pos < numSamples)
+    {
+        auto silentStart = pos;
+        while (pos < numSamples && isSilent (samples[pos]))
+            ++pos;
+        auto numSilent = pos - silentStart;
+
+        auto literalStart = pos;
+        size_t zeros = 0;
+        while (pos < numSamples && zeros < minSilentRun)
+        {
+            zeros = isSilent (samples[pos]) ? zeros + 1 : 0;
+            ++pos;
+        }
+        if (zeros > 0 && (zeros == minSilentRun || pos == numSamples))
+            pos -= zeros; // leave the trailing zeros to the next silent run
+
+        // literals go in the machine's byte order, little endian on every platform we build for
+        stream.writeInt ((int) numSilent);
+        stream.writeInt ((int) (pos - literalStart));
+        stream.write (samples + literalStart, (pos - literalStart) * sizeof (float));
+    }
+}
+
+//==============================================================================
+DspStateWriter::DspStateWriter (double rate, juce::MemoryBlock& storageToUse) noexcept
+    : storage (storageToUse), sampleRate (rate)
+{
+}
+
+// the raw copy is a tag per value, then its bytes; past the end of the storage
+// only the size is counted
+void DspStateWriter::append (const void* data, size_t numBytes) noexcept
+{
+    if (size + numBytes <= storage.getSize())
+        std::memcpy (static_cast<char*> (storage.getData()) + size, data, numBytes);
+    size += numBytes;
+}
+
+void DspStateWriter::append (char tag, const void* data, size_t numBytes) noexcept
+{
+    append (&tag, 1);
+    append (data, numBytes);
+}
+
+void DspStateWriter::writeSamples (const float* samples, size_t numSamples) noexcept
+{
+    auto count = (juce::int64) numSamples;
+    append (samplesTag, &count, sizeof (count));
+
+    // padded so the samples can be encoded straight from the copy
+    static constexpr char padding[sizeof (float)] = {};
+    append (padding, (sizeof (float) - size % sizeof (float)) % sizeof (float));
+    append (samples, numSamples * sizeof (float));
+}
+
+juce::MemoryBlock DspStateWriter::getCompressedData() const
+{
+    jassert (isComplete());
+
+    // the raw copy replayed into the stored format
+    juce::MemoryOutputStream stream;
+    stream.writeDouble (sampleRate);
+
+    auto* start = static_cast<const char*> (storage.getData());
+    auto* pos = start;
+    auto* end = pos + juce::jmin (size, storage.getSize());
+    while (pos < end)
+    {
+        auto tag = *pos++;
+        if (tag == floatTag)
+        {
+            float v;
+            std::memcpy (&v, pos, sizeof (v));
+            stream.writeFloat (v);
+            pos += sizeof (v);
+        }
+        else if (tag == doubleTag)
+        {
+            double v;
+            std::memcpy (&v, pos, sizeof (v));
+            stream.writeDouble (v);
+            pos += sizeof (v);
+        }
+        else
+        {
+            juce::int64 v;
+            std::memcpy (&v, pos, sizeof (v));
+            pos += sizeof (v);
+
+            if (tag == intTag)
+            {
+                stream.writeInt64 (v);
+            }
+            else
+            {
+                pos += (sizeof (float) - (size_t) (pos - start) % sizeof (float)) % sizeof (float);
+                encodeSamples (stream, reinterpret_cast<const float*> (pos), (size_t) v);
+                pos += (size_t) v * sizeof (float);
+            }
+        }
+    }
+
+    juce::MemoryOutputStream compressed;
+    {
+        juce::GZIPCompressorOutputStream zipper (compressed, 1); // fast, mostly removes what the silent runs left
+        zipper.write (stream.getData(), stream.getDataSize());
+    }
+    return compressed.getMemoryBlock();
+}
+
+//==============================================================================
+static juce::MemoryBlock decompress (const juce::MemoryBlock& compressedData)
+{
+    juce::MemoryInputStream compressed (compressedData, false);
+    juce::GZIPDecompressorInputStream unzipper (compressed);
+    juce::MemoryOutputStream decompressed;
+    decompressed.writeFromInputStream (unzipper, -1);
+    return decompressed.getMemoryBlock();
+}
+
+DspStateReader::DspStateReader (const juce::MemoryBlock& compressedData)
+    : data (decompress (compressedData)), stream (data, false)
+{
+    if (hasBytes (sizeof (double)))
+        sampleRate = stream.readDouble();
+}
+
+bool DspStateReader::readSamples (float* samples, size_t numSamples)
+{
+    juce::int64 numStored = 0;
+    if (! read (numStored) || numStored != (juce::int64) numSamples)
+        return false;
+
+    size_t pos = 0;
+    while (pos < numSamples)
+    {
+        if (! hasBytes (2 * sizeof (int)))
+            return false;
+
+        auto numSilent = (size_t) (juce::uint32) stream.readInt();
+        auto numLiteral = (size_t) (juce::uint32) stream.readInt();
+
+        if (numSilent + numLiteral == 0 || numSilent + numLiteral > numSamples - pos
+             || ! hasBytes (numLiteral * sizeof (float)))
+            return false;
+
+        std::fill (samples + pos, samples + pos + numSilent, 0.0f);
+        pos += numSilent;
+        stream.read (samples + pos, (int) (numLiteral * sizeof (float)));
+        pos += numLiteral;
+    }
+
+    return true;
+}
+
+} // namespace mda
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    mda_DspState.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    Writes a snapshot of a processor's live DSP state: delay lines, filter and
+    envelope states, oscillator phases. It is stored in the saved state, so a
+    session or a stopped render resumes with the tail it stopped on.
+
+    Values are stored exactly, integers as 64 bits whatever their type in the
+    processor. Buffers go through writeSamples(), which skips runs of
+    silence, and the whole snapshot is gzip compressed by getCompressedData().
+
+    Writing only copies the values into storage reserved beforehand, so it is
+    cheap enough to do while holding the audio thread off; getCompressedData()
+    does the encoding and should be called after releasing the lock. If the
+    storage was too small, isComplete() is false and getSize() tells how much
+    the copy needs.
+*/
+class DspStateWriter
+{
+public:
+    DspStateWriter (double sampleRate, juce::MemoryBlock& storage) noexcept;
+
+    template <typename Type>
+    void write (Type value) noexcept
+    {
+        if constexpr (std::is_same_v<Type, float>)
+        {
+            append (floatTag, &value, sizeof (value));
+        }
+        else if constexpr (std::is_same_v<Type, double>)
+        {
+            append (doubleTag, &value, sizeof (value));
+        }
+        else
+        {
+            auto v = (juce::int64) value;
+            append (intTag, &v, sizeof (v));
+        }
+    }
+
+    /** Writes the sample count, then the samples with runs of exact zeros left out. */
+    void writeSamples (const float* samples, size_t numSamples) noexcept;
+
+    bool isComplete() const noexcept                { return size <= storage.getSize(); }
+    size_t getSize() const noexcept                 { return size; }
+
+    juce::MemoryBlock getCompressedData() const;
+
+private:
+    static constexpr char floatTag = 'f', doubleTag = 'd', intTag = 'i', samplesTag = 's';
+
+    void append (char tag, const void* data, size_t numBytes) noexcept;
+    void append (const void* data, size_t numBytes) noexcept;
+
+    juce::MemoryBlock& storage;
+    size_t size = 0;
+    double sampleRate;
+
+    JUCE_DECLARE_NON_COPYABLE (DspStateWriter)
+};
+
+//==============================================================================
+/**
+    Reads a snapshot written by DspStateWriter. Every read returns false once
+    the data runs out or doesn't match, and the processor should then reset
+    rather than run from a half restored state.
+*/
+class DspStateReader
+{
+public:
+    /** Decompresses the snapshot, isValid() tells whether that worked. */
+    explicit DspStateReader (const juce::MemoryBlock& compressedData);
+
+    bool isValid() const noexcept                   { return sampleRate > 0.0; }
+
+    /** The rate the snapshot was taken at, buffers only fit at the same rate. */
+    double getSampleRate() const noexcept           { return sampleRate; }
+
+    template <typename Type>
+    bool read (Type& value)
+    {
+        if constexpr (std::is_same_v<Type, float>)
+        {
+            if (! hasBytes (sizeof (float)))
+                return false;
+            value = stream.readFloat();
+        }
+        else if constexpr (std::is_same_v<Type, double>)
+        {
+            if (! hasBytes (sizeof (double)))
+                return false;
+            value = stream.readDouble();
+        }
+        else
+        {
+            if (! hasBytes (sizeof (juce::int64)))
+                return false;
+            value = (Type) stream.readInt64();
+        }
+        return true;
+    }
+
+    /** Fails unless the stored sample count is numSamples. */
+    bool readSamples (float* samples, size_t numSamples);
+
+private:
+    bool hasBytes (size_t numBytes) const           { return stream.getNumBytesRemaining() >= (juce::int64) numBytes; }
+
+    juce::MemoryBlock data;
+    juce::MemoryInputStream stream;
+    double sampleRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE (DspStateReader)
+};
+
+} // namespace mda
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    mda_BlockProfiler.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    Splits the time spent in processBlock into the fixed per-block cost (the
+    preamble before the sample loop and the postamble after it) and the cost
+    per sample of the loop itself, and logs both every few thousand blocks.
+
+    At tiny host buffers the fixed cost dominates, so this shows how close a
+    16-sample block comes to the per-sample cost of a 512-sample block.
+
+    Only does anything when MDA_PROFILE_BLOCKS is set, otherwise all calls
+    compile to nothing. The report goes through DBG on the audio thread, so
+    it is meant for profiling builds only.
+*/
+class BlockProfiler
+{
+public:
+    explicit BlockProfiler (const char* name, int blocksPerReport = 20000) noexcept
+        : processorName (name), reportInterval (blocksPerReport)
+    {
+    }
+
+    void beginBlock() noexcept
+    {
+       #if MDA_PROFILE_BLOCKS
+        blockStart = juce::Time::getHighResolutionTicks();
+       #endif
+    }
+
+    void beginKernel() noexcept
+    {
+       #if MDA_PROFILE_BLOCKS
+        kernelStart = juce::Time::getHighResolutionTicks();
+       #endif
+    }
+
+    void endKernel() noexcept
+    {
+       #if MDA_PROFILE_BLOCKS
+        kernelTicks += juce::Time::getHighResolutionTicks() - kernelStart;
+       #endif
+    }
+
+    void endBlock (int numSamples) noexcept
+    {
+       #if MDA_PROFILE_BLOCKS
+        totalTicks += juce::Time::getHighResolutionTicks() - blockStart;
+        totalSamples += numSamples;
+
+        if (++numBlocks >= reportInterval)
+        {
+            auto ns = 1.0e9 / (double) juce::Time::getHighResolutionTicksPerSecond();
+            auto overhead = (double) (totalTicks - kernelTicks) * ns / numBlocks;
+            auto perSample = (double) kernelTicks * ns / (double) totalSamples;
+            auto blockSize = (double) totalSamples / numBlocks;
+
+            DBG (processorName << ": " << juce::String (overhead, 1) << " ns fixed per block, "
+                 << juce::String (perSample, 2) << " ns per sample in the loop, "
+                 << juce::String ((overhead / blockSize + perSample), 2) << " ns per sample overall at "
+                 << juce::String (blockSize, 0) << "-sample blocks");
+
+            numBlocks = 0;
+            totalSamples = 0;
+            totalTicks = kernelTicks = 0;
+        }
+       #else
+        juce::ignoreUnused (numSamples);
+       #endif
+    }
+
+private:
+    const char* processorName;
+    int reportInterval;
+
+   #if MDA_PROFILE_BLOCKS
+    juce::int64 blockStart = 0, kernelStart = 0;
+    juce::int64 totalTicks = 0, kernelTicks = 0, totalSamples = 0;
+    int numBlocks = 0;
+   #endif
+};
+
+} // namespace mda
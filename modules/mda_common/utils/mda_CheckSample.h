@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    mda_CheckSample.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+/** Debug check for an output sample: silences nan, inf and screaming
+    feedback, and clips anything else outside [-1, 1].
+*/
+template <typename SampleType>
+inline void checkSample (SampleType& x)
+{
+    if (std::isnan (x)) {
+        DBG ("!!! WARNING: nan detected in audio buffer, silencing !!!");
+        x = 0;
+    } else if (std::isinf (x)) {
+        DBG ("!!! WARNING: inf detected in audio buffer, silencing !!!");
+        x = 0;
+    } else if (x < -2 || x > 2) {  // screaming feedback
+        DBG ("!!! WARNING: sample out of range, silencing !!!");
+        x = 0;
+    } else if (x < -1) {
+        x = -1;
+    } else if (x > 1) {
+        x = 1;
+    }
+}
+
+} // namespace mda
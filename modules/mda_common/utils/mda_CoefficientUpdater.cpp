@@ -0,0 +1,23 @@
+/*
+  ==============================================================================
+
+    mda_CoefficientUpdater.cpp
+
+  ==============================================================================
+*/
+
+namespace mda
+{
+
+CoefficientThread::CoefficientThread()
+    : juce::TimeSliceThread ("mda coefficients")
+{
+    startThread (juce::Thread::Priority::low);
+}
+
+CoefficientThread::~CoefficientThread()
+{
+    stopThread (1000);
+}
+
+} // namespace mda
@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+    mda_CoefficientUpdater.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/**
+    Wait-free triple buffer handing immutable snapshots from one writer thread
+    to one reader thread. Neither side ever blocks or allocates; the reader
+    always sees the most recently published snapshot.
+*/
+template <typename Snapshot>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    /** Writer side: fill this in, then call publish(). */
+    Snapshot& getWriteBuffer() noexcept             { return buffers[(size_t) writeIndex]; }
+
+    void publish() noexcept
+    {
+        writeIndex = middle.exchange (writeIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    /** Reader side: returns true if a newer snapshot has been published since the last call. */
+    bool acquire() noexcept
+    {
+        if ((middle.load (std::memory_order_relaxed) & freshBit) == 0)
+            return false;
+
+        readIndex = middle.exchange (readIndex, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    const Snapshot& getReadBuffer() const noexcept  { return buffers[(size_t) readIndex]; }
+
+private:
+    static constexpr int indexMask = 3, freshBit = 4;
+
+    std::array<Snapshot, 3> buffers {};
+    std::atomic<int> middle { 1 };
+    int writeIndex = 0, readIndex = 2;
+
+    JUCE_DECLARE_NON_COPYABLE (TripleBuffer)
+};
+
+//==============================================================================
+/**
+    Background thread shared by every plugin instance in the process, which
+    recalculates coefficients after parameter changes.
+*/
+class CoefficientThread  : public juce::TimeSliceThread
+{
+public:
+    CoefficientThread();
+    ~CoefficientThread() override;
+
+    /** How often each instance checks for changed parameters, in milliseconds. */
+    static constexpr int pollIntervalMs = 2;
+};
+
+//==============================================================================
+/**
+    Recalculates a plugin's coefficients off the audio thread.
+
+    Parameter listeners mark the parameters they own as dirty, the shared
+    CoefficientThread recalculates only the affected coefficients into a
+    working copy and publishes it as an immutable snapshot. processBlock then
+    picks up the newest snapshot with pull(), at the cost of one atomic load
+    when nothing has changed.
+*/
+template <typename Coefficients>
+class CoefficientUpdater  : private juce::TimeSliceClient
+{
+public:
+    /** Recalculates the coefficients depending on the parameters set in the changed mask. */
+    using UpdateFunction = std::function<void (Coefficients&, juce::uint32 changed, double sampleRate)>;
+
+    explicit CoefficientUpdater (UpdateFunction updateFunction)
+        : update (std::move (updateFunction))
+    {
+    }
+
+    ~CoefficientUpdater() override
+    {
+        release();
+    }
+
+    /** Called by parameter listeners, from any thread. */
+    void markDirty (juce::uint32 changed) noexcept
+    {
+        dirty.fetch_or (changed, std::memory_order_release);
+    }
+
+    /** Recalculates everything for the new sample rate, publishes it and starts
+        watching for parameter changes. Call from prepareToPlay.
+    */
+    void prepare (double newSampleRate)
+    {
+        {
+            const juce::ScopedLock sl (lock);
+            sampleRate = newSampleRate;
+            dirty.store (0);
+            update (working, ~0u, sampleRate);
+            buffers.getWriteBuffer() = working;
+            buffers.publish();
+        }
+
+        if (! registered)
+        {
+            // the shared thread is only started by the first prepared instance,
+            // so constructing plugins while a host scans costs no thread
+            if (! thread.has_value())
+                thread.emplace();
+
+            (*thread)->addTimeSliceClient (this);
+            registered = true;
+        }
+    }
+
+    /** Stops watching for parameter changes. Call from releaseResources. */
+    void release()
+    {
+        if (registered)
+        {
+            (*thread)->removeTimeSliceClient (this);
+            registered = false;
+        }
+    }
+
+    /** Recalculates pending changes on the calling thread. Only use this where
+        blocking is acceptable, e.g. when rendering offline.
+    */
+    void updateNow()
+    {
+        const juce::ScopedLock sl (lock);
+        updatePending();
+    }
+
+    /** Holds back new snapshots until resume(), so parameters set one at a time,
+        e.g. by a program change, are picked up together. Never blocks, so it is
+        safe on the audio thread, where hosts may change programs.
+    */
+    void suspend() noexcept
+    {
+        suspendCount.fetch_add (1, std::memory_order_acq_rel);
+        suspensions.fetch_add (1, std::memory_order_acq_rel);
+    }
+
+    void resume() noexcept
+    {
+        auto previous = suspendCount.fetch_sub (1, std::memory_order_acq_rel);
+        jassert (previous > 0);
+        juce::ignoreUnused (previous);
+    }
+
+    /** Audio thread: returns the newest snapshot, or nullptr if nothing changed. */
+    const Coefficients* pull() noexcept
+    {
+        return buffers.acquire() ? &buffers.getReadBuffer() : nullptr;
+    }
+
+private:
+    int useTimeSlice() override
+    {
+        const juce::ScopedTryLock sl (lock);
+
+        if (sl.isLocked())
+            updatePending();
+
+        return CoefficientThread::pollIntervalMs;
+    }
+
+    void updatePending()
+    {
+        if (dirty.load (std::memory_order_relaxed) == 0 || sampleRate <= 0.0
+             || suspendCount.load (std::memory_order_acquire) > 0)
+            return;
+
+        auto before = suspensions.load (std::memory_order_acquire);
+        auto changed = dirty.exchange (0, std::memory_order_acquire);
+        update (working, changed, sampleRate);
+
+        // suspended before or while calculating: the snapshot may mix old and new
+        // values, so it is dropped and its bits wait for the next poll after resume()
+        if (suspendCount.load (std::memory_order_acquire) > 0 || suspensions.load (std::memory_order_acquire) != before)
+        {
+            dirty.fetch_or (changed, std::memory_order_release);
+            return;
+        }
+
+        buffers.getWriteBuffer() = working;
+        buffers.publish();
+    }
+
+    UpdateFunction update;
+    juce::CriticalSection lock; // between the worker and prepare() / updateNow()
+    std::atomic<int> suspendCount { 0 };
+    std::atomic<juce::uint32> suspensions { 0 }; // counts suspend() calls, so one that came and went is noticed
+    Coefficients working {};
+    double sampleRate = 0.0;
+    std::atomic<juce::uint32> dirty { 0 };
+    TripleBuffer<Coefficients> buffers;
+    std::optional<juce::SharedResourcePointer<CoefficientThread>> thread;
+    bool registered = false;
+
+    JUCE_DECLARE_NON_COPYABLE (CoefficientUpdater)
+};
+
+} // namespace mda
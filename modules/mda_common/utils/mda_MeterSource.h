@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    mda_MeterSource.h
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace mda
+{
+
+//==============================================================================
+/** One decimated metering snapshot, as sent from the audio thread to the editor. */
+struct MeterFrame
+{
+    float inputPeak[2] {}, outputPeak[2] {};
+    float values[2] {}; // plugin specific, e.g. delay time and limiter envelope
+};
+
+//==============================================================================
+/**
+    Sends decimated meter data from the audio thread to an editor through a
+    wait-free single producer / single consumer FIFO.
+
+    The audio thread only measures anything while an editor is attached, and
+    then only pushes one MeterFrame per display frame; peaks are merged in
+    between. Neither side allocates. When the editor falls behind, frames
+    are dropped rather than blocking the audio thread.
+*/
+class MeterSource
+{
+public:
+    MeterSource() = default;
+
+    /** Audio setup: sets how many frames per second are sent to the editor. */
+    void prepare (double sampleRate, double framesPerSecond = 60.0) noexcept
+    {
+        samplesPerFrame = juce::jmax (1, juce::roundToInt (sampleRate / framesPerSecond));
+        samplesPending = 0;
+        pending = {};
+    }
+
+    //==============================================================================
+    /** Editor side: metering only runs while at least one consumer is attached. */
+    void addConsumer() noexcept         { numConsumers.fetch_add (1); }
+    void removeConsumer() noexcept      { numConsumers.fetch_sub (1); }
+
+    /** Editor side: merges all frames received since the last call into frame.
+        Returns false if there was nothing new.
+    */
+    bool pull (MeterFrame& frame) noexcept
+    {
+        const auto scope = fifo.read (fifo.getNumReady());
+
+        if (scope.blockSize1 + scope.blockSize2 == 0)
+            return false;
+
+        frame = {};
+        scope.forEach ([this, &frame] (int index)
+        {
+            const auto& f = frames[(size_t) index];
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                frame.inputPeak[ch]  = juce::jmax (frame.inputPeak[ch],  f.inputPeak[ch]);
+                frame.outputPeak[ch] = juce::jmax (frame.outputPeak[ch], f.outputPeak[ch]);
+                frame.values[ch] = f.values[ch];
+            }
+        });
+
+        return true;
+    }
+
+    //==============================================================================
+    /** Audio thread: cheap check to skip all metering work while no editor is open. */
+    bool isActive() const noexcept      { return numConsumers.load (std::memory_order_relaxed) > 0; }
+
+    template <typename SampleType>
+    void measureInput (const juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
+    {
+        measure (buffer, numSamples, pending.inputPeak);
+    }
+
+    template <typename SampleType>
+    void measureOutput (const juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
+    {
+        measure (buffer, numSamples, pending.outputPeak);
+    }
+
+    /** Audio thread: call once per block after measuring; pushes a frame to the
+        editor whenever a display frame's worth of samples has been processed.
+    */
+    void push (int numSamples, float value0, float value1) noexcept
+    {
+        pending.values[0] = value0;
+        pending.values[1] = value1;
+
+        if ((samplesPending += numSamples) < samplesPerFrame)
+            return;
+
+        const auto scope = fifo.write (1);
+
+        if (scope.blockSize1 > 0)
+            frames[(size_t) scope.startIndex1] = pending;
+
+        pending = {};
+        samplesPending = 0;
+    }
+
+private:
+    template <typename SampleType>
+    static void measure (const juce::AudioBuffer<SampleType>& buffer, int numSamples, float* peaks) noexcept
+    {
+        const auto numChannels = juce::jmin (2, buffer.getNumChannels());
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            peaks[ch] = juce::jmax (peaks[ch], (float) buffer.getMagnitude (ch, 0, numSamples));
+
+        if (numChannels == 1)
+            peaks[1] = peaks[0];
+    }
+
+    static constexpr int capacity = 32;
+
+    juce::AbstractFifo fifo { capacity };
+    std::array<MeterFrame, (size_t) capacity> frames {};
+    MeterFrame pending;
+    int samplesPending = 0, samplesPerFrame = 1;
+    std::atomic<int> numConsumers { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (MeterSource)
+};
+
+} // namespace mda